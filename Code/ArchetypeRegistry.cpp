@@ -0,0 +1,112 @@
+#include "ArchetypeRegistry.hpp"
+
+#include "Bitmasking.hpp"
+#include "Component.hpp"
+#include "Entity.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+ArchetypeRegistry::~ArchetypeRegistry()
+{
+	for( unsigned int i = 0; i < m_archetypes.size(); ++i )
+	{
+		delete m_archetypes[ i ];
+	}
+	m_archetypes.clear();
+}
+
+
+
+#pragma region Entity Tracking
+//-----------------------------------------------------------------------------------------------
+/* Removal swaps the archetype's last row into the removed row, so it doesn't shift anything. */
+void ArchetypeRegistry::RemoveEntity( Entity& entity )
+{
+	if( entity.archetypeIndex == ARCHETYPE_None )
+		return;
+
+	Archetype& archetype = *m_archetypes[ entity.archetypeIndex ];
+	size_t removedRow = entity.archetypeRow;
+	size_t lastRow = archetype.entities.size() - 1;
+
+	if( removedRow != lastRow )
+	{
+		Entity* movedEntity = archetype.entities[ lastRow ];
+		archetype.entities[ removedRow ] = movedEntity;
+		movedEntity->archetypeRow = removedRow;
+
+		for( ComponentTypeID typeID = 0; typeID < MAX_INDEXED_COMPONENT_TYPES; ++typeID )
+		{
+			if( IsBitSetInMask( GetComponentTypeMaskBit( typeID ), archetype.signature ) )
+				archetype.componentColumns[ typeID ][ removedRow ] = archetype.componentColumns[ typeID ][ lastRow ];
+		}
+	}
+
+	archetype.entities.pop_back();
+	for( ComponentTypeID typeID = 0; typeID < MAX_INDEXED_COMPONENT_TYPES; ++typeID )
+	{
+		if( IsBitSetInMask( GetComponentTypeMaskBit( typeID ), archetype.signature ) )
+			archetype.componentColumns[ typeID ].pop_back();
+	}
+
+	entity.archetypeIndex = ARCHETYPE_None;
+	entity.archetypeRow = 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Called whenever an entity's attached components change. Entities with no indexed
+	components aren't kept in any archetype. */
+void ArchetypeRegistry::UpdateEntity( Entity& entity )
+{
+	ComponentTypeMask signature = entity.attachedComponentMask;
+	if( entity.archetypeIndex != ARCHETYPE_None && m_archetypes[ entity.archetypeIndex ]->signature == signature )
+	{
+		//Same signature, but a different component may now fill one of the columns
+		WriteEntityRow( *m_archetypes[ entity.archetypeIndex ], entity.archetypeRow, entity );
+		return;
+	}
+
+	RemoveEntity( entity );
+	if( signature == 0 )
+		return;
+
+	ArchetypeIndex archetypeIndex = FindOrCreateArchetype( signature );
+	Archetype& archetype = *m_archetypes[ archetypeIndex ];
+
+	entity.archetypeIndex = archetypeIndex;
+	entity.archetypeRow = archetype.entities.size();
+	archetype.entities.push_back( &entity );
+	for( ComponentTypeID typeID = 0; typeID < MAX_INDEXED_COMPONENT_TYPES; ++typeID )
+	{
+		if( IsBitSetInMask( GetComponentTypeMaskBit( typeID ), signature ) )
+			archetype.componentColumns[ typeID ].push_back( entity.indexedComponents[ typeID ] );
+	}
+}
+#pragma endregion //Entity Tracking
+
+
+
+#pragma region Helpers
+//-----------------------------------------------------------------------------------------------
+ArchetypeRegistry::ArchetypeIndex ArchetypeRegistry::FindOrCreateArchetype( ComponentTypeMask signature )
+{
+	std::map< ComponentTypeMask, ArchetypeIndex >::iterator foundArchetype = m_signatureToArchetypeIndex.find( signature );
+	if( foundArchetype != m_signatureToArchetypeIndex.end() )
+		return foundArchetype->second;
+
+	ArchetypeIndex newArchetypeIndex = m_archetypes.size();
+	m_archetypes.push_back( new Archetype( signature ) );
+	m_signatureToArchetypeIndex[ signature ] = newArchetypeIndex;
+	return newArchetypeIndex;
+}
+
+//-----------------------------------------------------------------------------------------------
+void ArchetypeRegistry::WriteEntityRow( Archetype& archetype, size_t row, const Entity& entity )
+{
+	for( ComponentTypeID typeID = 0; typeID < MAX_INDEXED_COMPONENT_TYPES; ++typeID )
+	{
+		if( IsBitSetInMask( GetComponentTypeMaskBit( typeID ), archetype.signature ) )
+			archetype.componentColumns[ typeID ][ row ] = entity.indexedComponents[ typeID ];
+	}
+}
+#pragma endregion //Helpers
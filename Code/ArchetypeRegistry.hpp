@@ -0,0 +1,70 @@
+#pragma once
+#ifndef INCLUDED_ARCHETYPE_REGISTRY_HPP
+#define INCLUDED_ARCHETYPE_REGISTRY_HPP
+
+//-----------------------------------------------------------------------------------------------
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include "ComponentTypeID.hpp"
+
+struct Component;
+struct Entity;
+
+
+//-----------------------------------------------------------------------------------------------
+/* All entities whose attached (indexed) component types match a signature exactly.
+	Rows are packed: entities[ i ] owns componentColumns[ typeID ][ i ] for every type in the
+	signature. The components themselves still live in their systems' pools. */
+struct Archetype
+{
+	Archetype( ComponentTypeMask archetypeSignature ) : signature( archetypeSignature ) { }
+
+	size_t GetNumberOfEntities() const { return entities.size(); }
+
+	//Data Members
+	ComponentTypeMask signature;
+	std::vector< Entity* > entities;
+	std::vector< Component* > componentColumns[ MAX_INDEXED_COMPONENT_TYPES ];
+};
+
+
+
+//-----------------------------------------------------------------------------------------------
+/* Groups an EntityManager's entities by component signature. Entities are moved between
+	archetypes as components are attached and detached, so queries never probe entities
+	that lack a requested component. */
+class ArchetypeRegistry
+{
+public:
+	typedef unsigned int ArchetypeIndex;
+	static const ArchetypeIndex ARCHETYPE_None = 0xffffffff;
+
+	ArchetypeRegistry() { }
+	~ArchetypeRegistry();
+
+	//Entity Tracking
+	void RemoveEntity( Entity& entity );
+	void UpdateEntity( Entity& entity );
+
+	//Archetype Access
+	size_t GetNumberOfArchetypes() const { return m_archetypes.size(); }
+	const Archetype& GetArchetype( ArchetypeIndex index ) const { return *m_archetypes[ index ]; }
+
+
+private:
+	//Having two registries track the same entities would scramble their rows.
+	ArchetypeRegistry( const ArchetypeRegistry& other );
+	ArchetypeRegistry& operator=( const ArchetypeRegistry& other );
+
+	//Helpers
+	ArchetypeIndex FindOrCreateArchetype( ComponentTypeMask signature );
+	void WriteEntityRow( Archetype& archetype, size_t row, const Entity& entity );
+
+	//Data Members
+	std::vector< Archetype* > m_archetypes;
+	std::map< ComponentTypeMask, ArchetypeIndex > m_signatureToArchetypeIndex;
+};
+
+#endif //INCLUDED_ARCHETYPE_REGISTRY_HPP
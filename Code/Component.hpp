@@ -12,6 +12,7 @@ ABSTRACT struct Component
 {
 	template<typename ComponentType>
 	friend class ComponentSystem;
+	friend struct Entity;
 
 
 protected:
@@ -24,14 +25,19 @@ public:
 	bool IsActive() const { return active; }
 	bool IsReadyForDeletion() const { return readyForDeletion; }
 
+	//False once the owner has been fired, even if its slot has since been rehired
+	bool OwnerIsCurrent() const { return ( owner != nullptr && owner->GetHandle() == ownerHandle ); }
+
 
 	//Data Members
 private:
 	bool active;
+	ComponentTypeID componentTypeID;
 
 public:
 	bool readyForDeletion;
 	Entity* owner;
+	EntityHandle ownerHandle; //The owner's handle as of attachment
 };
 
 
@@ -39,8 +45,10 @@ public:
 //-----------------------------------------------------------------------------------------------
 inline Component::Component()
 	: active( false )
+	, componentTypeID( 0 )
 	, readyForDeletion( false )
 	, owner( nullptr )
+	, ownerHandle()
 { }
 
 #endif //INCLUDED_COMPONENT_HPP
@@ -0,0 +1,138 @@
+#pragma once
+#ifndef INCLUDED_COMPONENT_QUERY_HPP
+#define INCLUDED_COMPONENT_QUERY_HPP
+
+//-----------------------------------------------------------------------------------------------
+#include "ArchetypeRegistry.hpp"
+#include "AssertionError.hpp"
+#include "Component.hpp"
+
+//-----------------------------------------------------------------------------------------------
+//Placeholder for unused ComponentQuery type parameters
+struct NoQueriedComponent;
+
+
+
+//-----------------------------------------------------------------------------------------------
+template< typename ComponentType >
+inline ComponentTypeMask GetQueryMaskBitForType()
+{
+	ComponentTypeID componentTypeID = GetComponentTypeID< ComponentType >();
+	FATAL_ASSERTION( componentTypeID < MAX_INDEXED_COMPONENT_TYPES, "Component Query Error",
+		"Only indexed component types can be queried!" );
+	return GetComponentTypeMaskBit( componentTypeID );
+}
+
+//-----------------------------------------------------------------------------------------------
+template<>
+inline ComponentTypeMask GetQueryMaskBitForType< NoQueriedComponent >()
+{
+	return 0;
+}
+
+
+
+//-----------------------------------------------------------------------------------------------
+/* Visits every archetype holding all of the queried component types, one packed span at a time:
+
+	for( ComponentQuery< PhysicsComponent, MeshComponent > query( registry ); !query.IsFinished(); query.Advance() )
+	{
+		for( size_t i = 0; i < query.GetNumberOfEntities(); ++i )
+			query.GetComponent< PhysicsComponent >( i )->...
+	}
+
+	Attaching or detaching components while a query is running can move entities between
+	archetypes, so defer those changes until after the loop. */
+template< typename ComponentA, typename ComponentB = NoQueriedComponent,
+		  typename ComponentC = NoQueriedComponent, typename ComponentD = NoQueriedComponent >
+class ComponentQuery
+{
+public:
+	ComponentQuery( const ArchetypeRegistry& registry );
+
+	//Iteration
+	void Advance();
+	bool IsFinished() const { return ( m_currentArchetypeIndex >= m_registry.GetNumberOfArchetypes() ); }
+
+	//Current Span
+	size_t GetNumberOfEntities() const { return GetCurrentArchetype().GetNumberOfEntities(); }
+	Entity* const* GetEntities() const { return &GetCurrentArchetype().entities[ 0 ]; }
+
+	template< typename ComponentType >
+	Component* const* GetComponentSpan() const;
+
+	template< typename ComponentType >
+	ComponentType* GetComponent( size_t entityIndex ) const;
+
+
+private:
+	const Archetype& GetCurrentArchetype() const { return m_registry.GetArchetype( m_currentArchetypeIndex ); }
+	void SkipNonMatchingArchetypes();
+
+	//Data Members
+	const ArchetypeRegistry& m_registry;
+	ComponentTypeMask m_queryMask;
+	ArchetypeRegistry::ArchetypeIndex m_currentArchetypeIndex;
+};
+
+
+
+//-----------------------------------------------------------------------------------------------
+template< typename ComponentA, typename ComponentB, typename ComponentC, typename ComponentD >
+inline ComponentQuery< ComponentA, ComponentB, ComponentC, ComponentD >::ComponentQuery( const ArchetypeRegistry& registry )
+	: m_registry( registry )
+	, m_queryMask( 0 )
+	, m_currentArchetypeIndex( 0 )
+{
+	m_queryMask = GetQueryMaskBitForType< ComponentA >() | GetQueryMaskBitForType< ComponentB >()
+				| GetQueryMaskBitForType< ComponentC >() | GetQueryMaskBitForType< ComponentD >();
+	SkipNonMatchingArchetypes();
+}
+
+
+
+#pragma region Iteration
+//-----------------------------------------------------------------------------------------------
+template< typename ComponentA, typename ComponentB, typename ComponentC, typename ComponentD >
+inline void ComponentQuery< ComponentA, ComponentB, ComponentC, ComponentD >::Advance()
+{
+	++m_currentArchetypeIndex;
+	SkipNonMatchingArchetypes();
+}
+
+//-----------------------------------------------------------------------------------------------
+template< typename ComponentA, typename ComponentB, typename ComponentC, typename ComponentD >
+inline void ComponentQuery< ComponentA, ComponentB, ComponentC, ComponentD >::SkipNonMatchingArchetypes()
+{
+	while( !IsFinished() )
+	{
+		const Archetype& archetype = GetCurrentArchetype();
+		if( ( archetype.signature & m_queryMask ) == m_queryMask && archetype.GetNumberOfEntities() != 0 )
+			return;
+
+		++m_currentArchetypeIndex;
+	}
+}
+#pragma endregion //Iteration
+
+
+
+#pragma region Current Span
+//-----------------------------------------------------------------------------------------------
+template< typename ComponentA, typename ComponentB, typename ComponentC, typename ComponentD >
+template< typename ComponentType >
+inline Component* const* ComponentQuery< ComponentA, ComponentB, ComponentC, ComponentD >::GetComponentSpan() const
+{
+	return &GetCurrentArchetype().componentColumns[ GetComponentTypeID< ComponentType >() ][ 0 ];
+}
+
+//-----------------------------------------------------------------------------------------------
+template< typename ComponentA, typename ComponentB, typename ComponentC, typename ComponentD >
+template< typename ComponentType >
+inline ComponentType* ComponentQuery< ComponentA, ComponentB, ComponentC, ComponentD >::GetComponent( size_t entityIndex ) const
+{
+	return static_cast< ComponentType* >( GetComponentSpan< ComponentType >()[ entityIndex ] );
+}
+#pragma endregion //Current Span
+
+#endif //INCLUDED_COMPONENT_QUERY_HPP
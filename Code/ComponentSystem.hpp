@@ -3,7 +3,11 @@
 #define INCLUDED_COMPONENT_SYSTEM_HPP
 
 //-----------------------------------------------------------------------------------------------
+#include <vector>
+
 #include "AssertionError.hpp"
+#include "Delegate.hpp"
+#include "EntityHandle.hpp"
 #include "StringConversion.hpp"
 #include "System.hpp"
 
@@ -16,6 +20,9 @@ public:
 	ComponentType* AcquireComponent();
 	void RelinquishComponent( ComponentType* component );
 
+	//For systems holding this pool's components in a DeferredRemovalVector
+	Delegate< void, ComponentType* > GetRelinquishDelegate();
+
 protected:
 	ComponentSystem( size_t maxComponentsInPool );
 
@@ -23,11 +30,20 @@ protected:
 	virtual void OnUpdate( float /*deltaSeconds*/ ) { }
 	virtual void OnDestruction();
 
+	void RelinquishComponentReference( ComponentType*& component ) { RelinquishComponent( component ); }
+
 
 	//Component Array
 	size_t m_numComponentsInPool;
 	ComponentType* m_componentPool;
-	size_t m_lastAcquiredComponentIndex;
+
+	//Pool Bookkeeping
+	/* m_activeComponents is a packed list of every acquired component, so derived systems should
+		iterate it in OnUpdate instead of walking the whole pool and testing IsActive(). Its order
+		changes whenever a component is relinquished. */
+	std::vector< ComponentType* > m_activeComponents;
+	std::vector< size_t > m_activeListIndexForPoolIndex;
+	std::vector< size_t > m_freePoolIndices;
 };
 
 
@@ -38,8 +54,17 @@ inline ComponentSystem<ComponentType>::ComponentSystem( size_t maxComponentsInPo
 	: System()
 	, m_numComponentsInPool( maxComponentsInPool )
 	, m_componentPool( new ComponentType[m_numComponentsInPool] )
-	, m_lastAcquiredComponentIndex( 0 )
-{ }
+	, m_activeListIndexForPoolIndex( maxComponentsInPool, 0 )
+{
+	m_activeComponents.reserve( m_numComponentsInPool );
+
+	//Pushed in reverse so that the front of the pool is handed out first
+	m_freePoolIndices.reserve( m_numComponentsInPool );
+	for( size_t i = m_numComponentsInPool; i > 0; --i )
+	{
+		m_freePoolIndices.push_back( i - 1 );
+	}
+}
 
 
 
@@ -59,36 +84,57 @@ inline VIRTUAL void ComponentSystem<ComponentType>::OnDestruction()
 template< typename ComponentType >
 inline ComponentType* ComponentSystem<ComponentType>::AcquireComponent()
 {
-	ComponentType* currentComponent = nullptr;
-
-	size_t i = m_lastAcquiredComponentIndex;
-	do 
+	if( m_freePoolIndices.empty() )
 	{
-		currentComponent = &m_componentPool[ i ];
-		if( !currentComponent->active )
-		{
-			currentComponent->active = true;
-			return currentComponent;
-		}
-
-		i = (i + 1)%m_numComponentsInPool;
-	} while (i != m_lastAcquiredComponentIndex);
-
-	std::string emptyPoolErrorMessage = "The component pool for ";
-	emptyPoolErrorMessage.append( typeid( ComponentType ).name() );
-	emptyPoolErrorMessage.append( " has run out of components to lend!\n" );
-	emptyPoolErrorMessage.append( "Current pool size: " );
-	emptyPoolErrorMessage.append( ConvertIntegerToString( m_numComponentsInPool ) );
-	FATAL_ERROR( "Component System Error", emptyPoolErrorMessage.c_str()  );
+		std::string emptyPoolErrorMessage = "The component pool for ";
+		emptyPoolErrorMessage.append( typeid( ComponentType ).name() );
+		emptyPoolErrorMessage.append( " has run out of components to lend!\n" );
+		emptyPoolErrorMessage.append( "Current pool size: " );
+		emptyPoolErrorMessage.append( ConvertIntegerToString( m_numComponentsInPool ) );
+		FATAL_ERROR( "Component System Error", emptyPoolErrorMessage.c_str()  );
+	}
+
+	size_t poolIndex = m_freePoolIndices.back();
+	m_freePoolIndices.pop_back();
+
+	ComponentType* acquiredComponent = &m_componentPool[ poolIndex ];
+	acquiredComponent->active = true;
+
+	m_activeListIndexForPoolIndex[ poolIndex ] = m_activeComponents.size();
+	m_activeComponents.push_back( acquiredComponent );
+	return acquiredComponent;
 }
 
 //-----------------------------------------------------------------------------------------------
 template< typename ComponentType >
 inline void ComponentSystem<ComponentType>::RelinquishComponent( ComponentType* component )
 {
+	if( !component->active )
+		return;
+
 	component->active = false;
 	component->readyForDeletion = false;
 	component->owner = nullptr;
+	component->ownerHandle = EntityHandle();
+
+	//Swap the last active component into the relinquished component's place in the active list
+	size_t poolIndex = component - m_componentPool;
+	size_t activeListIndex = m_activeListIndexForPoolIndex[ poolIndex ];
+	ComponentType* lastActiveComponent = m_activeComponents.back();
+
+	m_activeComponents[ activeListIndex ] = lastActiveComponent;
+	m_activeListIndexForPoolIndex[ lastActiveComponent - m_componentPool ] = activeListIndex;
+	m_activeComponents.pop_back();
+
+	m_freePoolIndices.push_back( poolIndex );
+}
+
+//-----------------------------------------------------------------------------------------------
+template< typename ComponentType >
+inline Delegate< void, ComponentType* > ComponentSystem<ComponentType>::GetRelinquishDelegate()
+{
+	return Delegate< void, ComponentType* >::template GenerateFromOneArgFunction< ComponentSystem<ComponentType>,
+		&ComponentSystem<ComponentType>::RelinquishComponentReference >( this );
 }
 #pragma endregion //Component Acquisition
 
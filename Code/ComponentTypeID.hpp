@@ -0,0 +1,51 @@
+#pragma once
+#ifndef INCLUDED_COMPONENT_TYPE_ID_HPP
+#define INCLUDED_COMPONENT_TYPE_ID_HPP
+
+//-----------------------------------------------------------------------------------------------
+#include "EngineMacros.hpp"
+
+#if !defined( PLATFORM_SINGLE_THREADED )
+	#include <atomic>
+#endif
+
+//-----------------------------------------------------------------------------------------------
+typedef unsigned int ComponentTypeID;
+typedef unsigned int ComponentTypeMask;
+
+//Component types with IDs below this get a bit in each entity's component mask and a lookup slot
+static const ComponentTypeID MAX_INDEXED_COMPONENT_TYPES = 32;
+
+
+
+//-----------------------------------------------------------------------------------------------
+/* The first lookup of a component type can happen on a job worker, so threaded builds hand out
+	IDs from an atomic counter. (Threaded builds also guarantee thread-safe initialization of the
+	function-local static in GetComponentTypeID.) */
+inline ComponentTypeID GenerateNextComponentTypeID()
+{
+#if defined( PLATFORM_SINGLE_THREADED )
+	static ComponentTypeID s_nextComponentTypeID = 0;
+#else
+	static std::atomic< ComponentTypeID > s_nextComponentTypeID( 0 );
+#endif
+	return s_nextComponentTypeID++;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Each instantiation grabs the next ID the first time it is asked for one, so IDs are handed
+	out in order of first use rather than being stable between runs. No RTTI is involved. */
+template< typename ComponentType >
+inline ComponentTypeID GetComponentTypeID()
+{
+	static const ComponentTypeID s_componentTypeID = GenerateNextComponentTypeID();
+	return s_componentTypeID;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline ComponentTypeMask GetComponentTypeMaskBit( ComponentTypeID typeID )
+{
+	return ( 1u << typeID );
+}
+
+#endif //INCLUDED_COMPONENT_TYPE_ID_HPP
@@ -0,0 +1,125 @@
+#pragma once
+#ifndef INCLUDED_DEFERRED_REMOVAL_VECTOR_HPP
+#define INCLUDED_DEFERRED_REMOVAL_VECTOR_HPP
+
+//-----------------------------------------------------------------------------------------------
+#include <cstddef>
+#include <vector>
+
+#include "Delegate.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+/* The element list every System keeps of the things it updates or renders.
+	Elements flagged for removal during the frame stay in place until the system's end-of-frame
+	sweep, which removes all of them in one pass and hands each one to the element releaser.
+	By default the releaser deletes the element; systems whose elements come from a pool
+	(see ComponentSystem::GetRelinquishDelegate) should set a releaser that returns them to it. */
+template< typename ElementType >
+class DeferredRemovalVector
+{
+public:
+	typedef Delegate< void, ElementType* > ElementReleaser;
+
+	typedef unsigned char RemovalOrder;
+	static const RemovalOrder REMOVAL_SWAP_AND_POP = 0; //Fastest, but the last element fills each hole
+	static const RemovalOrder REMOVAL_PRESERVES_ORDER = 1; //Remaining elements keep their relative order
+
+	DeferredRemovalVector( RemovalOrder removalOrder = REMOVAL_SWAP_AND_POP );
+
+	//Element Access
+	void AddElement( ElementType* element ) { m_elements.push_back( element ); }
+	size_t GetNumberOfElements() const { return m_elements.size(); }
+	ElementType* operator[]( size_t index ) const { return m_elements[ index ]; }
+	void Reserve( size_t numberOfElements ) { m_elements.reserve( numberOfElements ); }
+
+	//Removal
+	void SetElementReleaser( const ElementReleaser& releaser ) { m_releaseElement = releaser; }
+	void ReleaseAllElements();
+	void RemoveElementsReadyForDeletion();
+
+	template< typename RemovalCondition >
+	void RemoveElementsWhere( const RemovalCondition& shouldRemoveElement );
+
+
+private:
+	//-------------------------------------------------------------------------------------------
+	struct ElementIsReadyForDeletion
+	{
+		bool operator()( const ElementType* element ) const { return element->IsReadyForDeletion(); }
+	};
+
+	static void DeleteElement( ElementType*& element ) { delete element; element = nullptr; }
+
+	//Data Members
+	std::vector< ElementType* > m_elements;
+	RemovalOrder m_removalOrder;
+	ElementReleaser m_releaseElement;
+};
+
+
+
+//-----------------------------------------------------------------------------------------------
+template< typename ElementType >
+inline DeferredRemovalVector< ElementType >::DeferredRemovalVector( RemovalOrder removalOrder )
+	: m_removalOrder( removalOrder )
+	, m_releaseElement( ElementReleaser::template GenerateFromOneArgFunction< &DeferredRemovalVector< ElementType >::DeleteElement >() )
+{ }
+
+
+
+#pragma region Removal
+//-----------------------------------------------------------------------------------------------
+template< typename ElementType >
+inline void DeferredRemovalVector< ElementType >::ReleaseAllElements()
+{
+	for( unsigned int i = 0; i < m_elements.size(); ++i )
+	{
+		m_releaseElement( m_elements[ i ] );
+	}
+	m_elements.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+template< typename ElementType >
+inline void DeferredRemovalVector< ElementType >::RemoveElementsReadyForDeletion()
+{
+	RemoveElementsWhere( ElementIsReadyForDeletion() );
+}
+
+//-----------------------------------------------------------------------------------------------
+template< typename ElementType >
+template< typename RemovalCondition >
+inline void DeferredRemovalVector< ElementType >::RemoveElementsWhere( const RemovalCondition& shouldRemoveElement )
+{
+	if( m_removalOrder == REMOVAL_SWAP_AND_POP )
+	{
+		size_t i = 0;
+		while( i < m_elements.size() )
+		{
+			if( shouldRemoveElement( m_elements[ i ] ) )
+			{
+				m_releaseElement( m_elements[ i ] );
+				m_elements[ i ] = m_elements.back();
+				m_elements.pop_back();
+			}
+			else
+				++i;
+		}
+	}
+	else
+	{
+		size_t numberOfKeptElements = 0;
+		for( size_t i = 0; i < m_elements.size(); ++i )
+		{
+			if( shouldRemoveElement( m_elements[ i ] ) )
+				m_releaseElement( m_elements[ i ] );
+			else
+				m_elements[ numberOfKeptElements++ ] = m_elements[ i ];
+		}
+		m_elements.resize( numberOfKeptElements );
+	}
+}
+#pragma endregion //Removal
+
+#endif //INCLUDED_DEFERRED_REMOVAL_VECTOR_HPP
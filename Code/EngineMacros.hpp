@@ -77,6 +77,15 @@
 #endif
 
 
+
+//Threading
+//No std::thread, std::mutex or thread_local here, which includes Microsoft compilers before VS2015
+#if defined( PLATFORM_HTML5 ) || defined( PLATFORM_PS3 ) || defined( PLATFORM_VITA ) || \
+	( defined( COMPILER_MICROSOFT_C ) && ( COMPILER_MICROSOFT_C_VERSION < 1900 ) )
+	#define PLATFORM_SINGLE_THREADED
+#endif
+
+
 //Debugger Specific
 #if defined( PLATFORM_PS3 ) && defined( SN_TARGET_PS3 )
 	#define DEBUGGER_PS3_PRODG
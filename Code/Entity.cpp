@@ -1,9 +1,114 @@
 #include "Entity.hpp"
 
 #include "Component.hpp"
+#include "DebuggerInterface.hpp"
+#include "TimeInterface.hpp"
+
+
+#pragma region Component Lookup Benchmark
+//-----------------------------------------------------------------------------------------------
+template< unsigned int TypeNumber >
+struct BenchmarkComponent : public Component
+{
+	BenchmarkComponent() : Component() { }
+};
+
+//-----------------------------------------------------------------------------------------------
+template< typename ComponentType >
+ComponentType* FindComponentWithDynamicCast( const std::vector< Component* >& components )
+{
+	ComponentType* foundComponent;
+	for( unsigned int i = 0; i < components.size(); ++i )
+	{
+		foundComponent = dynamic_cast< ComponentType* >( components[ i ] );
+
+		if( foundComponent != nullptr )
+			return foundComponent;
+	}
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+template< unsigned int TypeNumber >
+void AttachBenchmarkComponents( Entity& entity, std::vector< Component* >& out_components, unsigned int numberToAttach )
+{
+	if( TypeNumber >= numberToAttach )
+		return;
+
+	BenchmarkComponent< TypeNumber >* component = new BenchmarkComponent< TypeNumber >();
+	entity.AttachComponent( component );
+	out_components.push_back( component );
+	AttachBenchmarkComponents< TypeNumber + 1 >( entity, out_components, numberToAttach );
+}
+
+//-----------------------------------------------------------------------------------------------
+template<>
+void AttachBenchmarkComponents< 16 >( Entity&, std::vector< Component* >&, unsigned int )
+{ }
+
+//-----------------------------------------------------------------------------------------------
+void BenchmarkComponentLookup()
+{
+	static const unsigned int NUMBER_OF_LOOKUPS = 1000000;
+	typedef BenchmarkComponent< 15 > LastComponentType;
+
+	for( unsigned int numberOfComponents = 1; numberOfComponents <= 16; ++numberOfComponents )
+	{
+		Entity entity;
+		std::vector< Component* > components;
+		AttachBenchmarkComponents< 0 >( entity, components, numberOfComponents );
+
+		//The last type is only attached on the final pass, so most passes measure a miss
+		unsigned int foundCount = 0;
+		double startTimeSeconds = GetCurrentTimeSeconds();
+		for( unsigned int i = 0; i < NUMBER_OF_LOOKUPS; ++i )
+		{
+			if( FindComponentWithDynamicCast< LastComponentType >( entity.attachedComponents ) != nullptr )
+				++foundCount;
+		}
+		double dynamicCastSeconds = GetCurrentTimeSeconds() - startTimeSeconds;
+
+		startTimeSeconds = GetCurrentTimeSeconds();
+		for( unsigned int i = 0; i < NUMBER_OF_LOOKUPS; ++i )
+		{
+			if( entity.FindAttachedComponentOfType< LastComponentType >() != nullptr )
+				++foundCount;
+		}
+		double lookupTableSeconds = GetCurrentTimeSeconds() - startTimeSeconds;
+
+		PrintfToDebuggerOutput( "Component lookup with %2u components: dynamic_cast scan %.3f ms, lookup table %.3f ms (%u found)\n",
+			numberOfComponents, dynamicCastSeconds * 1000.0, lookupTableSeconds * 1000.0, foundCount );
+
+		entity.DetachAllComponents();
+		for( unsigned int i = 0; i < components.size(); ++i )
+		{
+			delete components[ i ];
+		}
+	}
+}
+#pragma endregion //Component Lookup Benchmark
+
 
 
 //-----------------------------------------------------------------------------------------------
 Entity::~Entity()
 {
 }
+
+//-----------------------------------------------------------------------------------------------
+Component* Entity::FindAttachedComponentWithTypeID( ComponentTypeID componentTypeID ) const
+{
+	for( unsigned int i = 0; i < attachedComponents.size(); ++i )
+	{
+		if( attachedComponents[ i ]->componentTypeID == componentTypeID )
+			return attachedComponents[ i ];
+	}
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+void Entity::NotifyArchetypeRegistry()
+{
+	if( archetypeRegistry != nullptr )
+		archetypeRegistry->UpdateEntity( *this );
+}
@@ -8,15 +8,27 @@
 
 #include "Math/EulerAngles.hpp"
 #include "Math/FloatVector3.hpp"
+#include "ArchetypeRegistry.hpp"
+#include "Bitmasking.hpp"
+#include "ComponentTypeID.hpp"
+#include "EntityHandle.hpp"
+#include "EntityTransformStore.hpp"
 
 struct Component;
 class EntityBlueprint;
 
+//-----------------------------------------------------------------------------------------------
+/* Benchmark comparing the component lookup table against the old dynamic_cast scan.
+	This assigns type IDs to 16 benchmark-only component types, which uses up indexed
+	type slots, so run it from a test harness rather than inside a running game. */
+void BenchmarkComponentLookup();
+
 //-----------------------------------------------------------------------------------------------
 struct Entity
 {
 private:
 	static const unsigned int ID_Null = 0;
+	friend class ArchetypeRegistry;
 	friend class EntityManager;
 
 
@@ -31,6 +43,7 @@ public:
 	
 
 	//Component Helpers
+	//Lookups match the exact type a component was attached as; base class lookups no longer match.
 	template< typename ComponentType >
 	void AttachComponent( ComponentType* componentToAttach );
 
@@ -43,9 +56,35 @@ public:
 	template< typename ComponentType >
 	bool HasAttachedComponentOfType();
 
+	void DetachAllComponents();
+
 
 	//Entity Management Helpers
 	bool IsHired() const { return ( id != ID_Null ); }
+	EntityHandle GetHandle() const { return EntityHandle( slotIndex, generation ); }
+
+
+	//Kinematics Accessors
+	FloatVector3 GetPosition() const;
+	FloatVector3 GetVelocity() const;
+	FloatVector3 GetAcceleration() const;
+	EulerAngles GetOrientation() const;
+	EulerAngles GetAngularVelocity() const;
+
+	//Where the entity was before its latest fixed simulation step (see TerrestrialPhysicsSystem)
+	FloatVector3 GetPreviousPosition() const;
+	FloatVector3 GetInterpolatedPosition( float interpolationAlpha ) const;
+
+	//Moves the entity without interpolation; previous and current position both become newPosition
+	void SetPosition( const FloatVector3& newPosition );
+	void SetSimulatedPosition( const FloatVector3& positionBeforeStep, const FloatVector3& positionAfterStep );
+	void SetVelocity( const FloatVector3& newVelocity );
+	void SetAcceleration( const FloatVector3& newAcceleration );
+	void SetOrientation( const EulerAngles& newOrientation );
+	void SetAngularVelocity( const EulerAngles& newAngularVelocity );
+
+	//Returns nullptr unless this entity's manager keeps kinematics in a transform store
+	EntityTransformStore* GetTransformStore() const { return transformStore; }
 
 
 	//Data Members
@@ -55,14 +94,31 @@ public:
 	EntityBlueprint* blueprint;
 	std::vector< Component* > attachedComponents;
 
+private:
+	Entity* nextFiredEntity;
+	EntityHandle::SlotIndex slotIndex;
+	EntityHandle::Generation generation;
+
+	//Component Lookup (first attached component of each indexed type)
+	ComponentTypeMask attachedComponentMask;
+	Component* indexedComponents[ MAX_INDEXED_COMPONENT_TYPES ];
+
+	Component* FindAttachedComponentWithTypeID( ComponentTypeID componentTypeID ) const;
+	void NotifyArchetypeRegistry();
+
+	//Archetype Membership (only tracked for entities owned by an EntityManager)
+	ArchetypeRegistry* archetypeRegistry;
+	ArchetypeRegistry::ArchetypeIndex archetypeIndex;
+	size_t archetypeRow;
+
+	//Kinematics (only used when transformStore is nullptr)
+	EntityTransformStore* transformStore;
 	FloatVector3 position;
+	FloatVector3 previousPosition;
 	FloatVector3 velocity;
 	FloatVector3 acceleration;
 	EulerAngles orientation;
 	EulerAngles angularVelocity;
-
-private:
-	Entity* nextFiredEntity;
 };
 
 
@@ -74,7 +130,136 @@ inline Entity::Entity()
 	, creator( nullptr )
 	, blueprint( nullptr )
 	, nextFiredEntity( nullptr )
-{ }
+	, slotIndex( EntityHandle::SLOT_Invalid )
+	, generation( 0 )
+	, attachedComponentMask( 0 )
+	, archetypeRegistry( nullptr )
+	, archetypeIndex( ArchetypeRegistry::ARCHETYPE_None )
+	, archetypeRow( 0 )
+	, transformStore( nullptr )
+{
+	for( unsigned int i = 0; i < MAX_INDEXED_COMPONENT_TYPES; ++i )
+	{
+		indexedComponents[ i ] = nullptr;
+	}
+}
+
+
+
+#pragma region Kinematics Accessors
+//-----------------------------------------------------------------------------------------------
+inline FloatVector3 Entity::GetPosition() const
+{
+	if( transformStore != nullptr )
+		return transformStore->GetPosition( slotIndex );
+	return position;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline FloatVector3 Entity::GetVelocity() const
+{
+	if( transformStore != nullptr )
+		return transformStore->GetVelocity( slotIndex );
+	return velocity;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline FloatVector3 Entity::GetAcceleration() const
+{
+	if( transformStore != nullptr )
+		return transformStore->GetAcceleration( slotIndex );
+	return acceleration;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline EulerAngles Entity::GetOrientation() const
+{
+	if( transformStore != nullptr )
+		return transformStore->GetOrientation( slotIndex );
+	return orientation;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline EulerAngles Entity::GetAngularVelocity() const
+{
+	if( transformStore != nullptr )
+		return transformStore->GetAngularVelocity( slotIndex );
+	return angularVelocity;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline FloatVector3 Entity::GetPreviousPosition() const
+{
+	if( transformStore != nullptr )
+		return transformStore->GetPreviousPosition( slotIndex );
+	return previousPosition;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* An alpha of 0 gives the previous position and 1 gives the current one. */
+inline FloatVector3 Entity::GetInterpolatedPosition( float interpolationAlpha ) const
+{
+	FloatVector3 previous = GetPreviousPosition();
+	return previous + ( GetPosition() - previous ) * interpolationAlpha;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline void Entity::SetPosition( const FloatVector3& newPosition )
+{
+	SetSimulatedPosition( newPosition, newPosition );
+}
+
+//-----------------------------------------------------------------------------------------------
+inline void Entity::SetSimulatedPosition( const FloatVector3& positionBeforeStep, const FloatVector3& positionAfterStep )
+{
+	if( transformStore != nullptr )
+	{
+		transformStore->SetPreviousPosition( slotIndex, positionBeforeStep );
+		transformStore->SetPosition( slotIndex, positionAfterStep );
+	}
+	else
+	{
+		previousPosition = positionBeforeStep;
+		position = positionAfterStep;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+inline void Entity::SetVelocity( const FloatVector3& newVelocity )
+{
+	if( transformStore != nullptr )
+		transformStore->SetVelocity( slotIndex, newVelocity );
+	else
+		velocity = newVelocity;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline void Entity::SetAcceleration( const FloatVector3& newAcceleration )
+{
+	if( transformStore != nullptr )
+		transformStore->SetAcceleration( slotIndex, newAcceleration );
+	else
+		acceleration = newAcceleration;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline void Entity::SetOrientation( const EulerAngles& newOrientation )
+{
+	if( transformStore != nullptr )
+		transformStore->SetOrientation( slotIndex, newOrientation );
+	else
+		orientation = newOrientation;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline void Entity::SetAngularVelocity( const EulerAngles& newAngularVelocity )
+{
+	if( transformStore != nullptr )
+		transformStore->SetAngularVelocity( slotIndex, newAngularVelocity );
+	else
+		angularVelocity = newAngularVelocity;
+}
+#pragma endregion //Kinematics Accessors
 
 
 
@@ -83,8 +268,20 @@ inline Entity::Entity()
 template< typename ComponentType >
 void Entity::AttachComponent( ComponentType* componentToAttach )
 {
+	const ComponentTypeID componentTypeID = GetComponentTypeID< ComponentType >();
+
 	attachedComponents.push_back( componentToAttach );
 	componentToAttach->owner = this;
+	componentToAttach->ownerHandle = GetHandle();
+	componentToAttach->componentTypeID = componentTypeID;
+
+	if( componentTypeID < MAX_INDEXED_COMPONENT_TYPES &&
+		!IsBitSetInMask( GetComponentTypeMaskBit( componentTypeID ), attachedComponentMask ) )
+	{
+		indexedComponents[ componentTypeID ] = componentToAttach;
+		SetBitInMask( GetComponentTypeMaskBit( componentTypeID ), attachedComponentMask );
+		NotifyArchetypeRegistry();
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -98,32 +295,62 @@ void Entity::DetachComponent( ComponentType* componentToDetach )
 		if( component == componentToDetach )
 		{
 			componentToDetach->owner = nullptr;
+			componentToDetach->ownerHandle = EntityHandle();
 			attachedComponents.erase( attachedComponents.begin() + i );
+			break;
 		}
 	}
+
+	const ComponentTypeID componentTypeID = componentToDetach->componentTypeID;
+	if( componentTypeID >= MAX_INDEXED_COMPONENT_TYPES || indexedComponents[ componentTypeID ] != componentToDetach )
+		return;
+
+	//Hand the lookup slot to the next attached component of the same type, if there is one
+	indexedComponents[ componentTypeID ] = FindAttachedComponentWithTypeID( componentTypeID );
+	if( indexedComponents[ componentTypeID ] == nullptr )
+		UnsetBitInMask( GetComponentTypeMaskBit( componentTypeID ), attachedComponentMask );
+	NotifyArchetypeRegistry();
 }
 
 //-----------------------------------------------------------------------------------------------
 template< typename ComponentType >
 ComponentType* Entity::FindAttachedComponentOfType()
 {
-	ComponentType* foundComponent;
-	for( unsigned int i = 0; i < attachedComponents.size(); ++i )
+	const ComponentTypeID componentTypeID = GetComponentTypeID< ComponentType >();
+	if( componentTypeID < MAX_INDEXED_COMPONENT_TYPES )
 	{
-		foundComponent = dynamic_cast< ComponentType* >( attachedComponents[ i ] );
-
-		if( foundComponent != nullptr )
-			return foundComponent;
+		if( !IsBitSetInMask( GetComponentTypeMaskBit( componentTypeID ), attachedComponentMask ) )
+			return nullptr;
+		return static_cast< ComponentType* >( indexedComponents[ componentTypeID ] );
 	}
-	return nullptr;
+
+	//Types past the indexed range fall back to scanning the attached components' type IDs
+	return static_cast< ComponentType* >( FindAttachedComponentWithTypeID( componentTypeID ) );
 }
 
 //-----------------------------------------------------------------------------------------------
 template< typename ComponentType >
 bool Entity::HasAttachedComponentOfType()
 {
+	const ComponentTypeID componentTypeID = GetComponentTypeID< ComponentType >();
+	if( componentTypeID < MAX_INDEXED_COMPONENT_TYPES )
+		return IsBitSetInMask( GetComponentTypeMaskBit( componentTypeID ), attachedComponentMask );
+
 	return ( FindAttachedComponentOfType< ComponentType >() != nullptr );
 }
+
+//-----------------------------------------------------------------------------------------------
+inline void Entity::DetachAllComponents()
+{
+	attachedComponents.clear();
+
+	for( unsigned int i = 0; i < MAX_INDEXED_COMPONENT_TYPES; ++i )
+	{
+		indexedComponents[ i ] = nullptr;
+	}
+	attachedComponentMask = 0;
+	NotifyArchetypeRegistry();
+}
 #pragma endregion //Component Helpers
 
 #endif //INCLUDED_ENTITY_HPP
@@ -0,0 +1,44 @@
+#pragma once
+#ifndef INCLUDED_ENTITY_HANDLE_HPP
+#define INCLUDED_ENTITY_HANDLE_HPP
+
+//-----------------------------------------------------------------------------------------------
+/* A weak reference to an entity slot in the EntityManager's pool.
+	The generation is bumped every time the slot's entity is fired, so a handle to a fired
+	entity will no longer resolve even after the slot is hired again. */
+struct EntityHandle
+{
+	typedef unsigned int SlotIndex;
+	typedef unsigned int Generation;
+	static const SlotIndex SLOT_Invalid = 0xffffffff;
+
+	EntityHandle();
+	EntityHandle( SlotIndex entitySlotIndex, Generation entityGeneration );
+
+	//Helpers
+	bool IsNull() const { return ( slotIndex == SLOT_Invalid ); }
+
+	//Operators
+	bool operator==( const EntityHandle& rhs ) const { return ( slotIndex == rhs.slotIndex ) && ( generation == rhs.generation ); }
+	bool operator!=( const EntityHandle& rhs ) const { return !( *this == rhs ); }
+
+	//Data Members
+	SlotIndex slotIndex;
+	Generation generation;
+};
+
+
+
+//-----------------------------------------------------------------------------------------------
+inline EntityHandle::EntityHandle()
+	: slotIndex( SLOT_Invalid )
+	, generation( 0 )
+{ }
+
+//-----------------------------------------------------------------------------------------------
+inline EntityHandle::EntityHandle( SlotIndex entitySlotIndex, Generation entityGeneration )
+	: slotIndex( entitySlotIndex )
+	, generation( entityGeneration )
+{ }
+
+#endif //INCLUDED_ENTITY_HANDLE_HPP
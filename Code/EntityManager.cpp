@@ -27,41 +27,55 @@ void EntityManager::DoAtEndOfFrame()
 //-----------------------------------------------------------------------------------------------
 void EntityManager::FireEntity( Entity* entity )
 {
-	entity->position.x = entity->position.y = entity->position.z = 0.f;
-	entity->velocity.x = entity->velocity.y = entity->velocity.z = 0.f;
-	entity->acceleration.x = entity->acceleration.y = entity->acceleration.z = 0.f;
-	entity->orientation.rollDegreesAboutX	= entity->angularVelocity.rollDegreesAboutX = 0.f;
-	entity->orientation.pitchDegreesAboutY	= entity->angularVelocity.pitchDegreesAboutY = 0.f;
-	entity->orientation.yawDegreesAboutZ	= entity->angularVelocity.yawDegreesAboutZ = 0.f;
+	//Firing the same entity twice would link it into the jobless list twice
+	if( !entity->IsHired() )
+		return;
+
+	if( m_transformStore != nullptr )
+	{
+		m_transformStore->ClearSlot( entity->slotIndex );
+	}
+	else
+	{
+		entity->position.x = entity->position.y = entity->position.z = 0.f;
+		entity->previousPosition.x = entity->previousPosition.y = entity->previousPosition.z = 0.f;
+		entity->velocity.x = entity->velocity.y = entity->velocity.z = 0.f;
+		entity->acceleration.x = entity->acceleration.y = entity->acceleration.z = 0.f;
+		entity->orientation.rollDegreesAboutX	= entity->angularVelocity.rollDegreesAboutX = 0.f;
+		entity->orientation.pitchDegreesAboutY	= entity->angularVelocity.pitchDegreesAboutY = 0.f;
+		entity->orientation.yawDegreesAboutZ	= entity->angularVelocity.yawDegreesAboutZ = 0.f;
+	}
 
 	for( unsigned int i = 0; i < entity->attachedComponents.size(); ++i )
 	{
 		entity->attachedComponents[ i ]->readyForDeletion = true;
 	}
-	entity->attachedComponents.clear();
+	entity->DetachAllComponents();
 
 	entity->id = Entity::ID_Null;
 	entity->typeID = Entity::TYPEID_None;
+	entity->creator = nullptr;
 	entity->blueprint = nullptr;
+	++entity->generation; //Invalidates every outstanding handle to this entity
+
+	entity->nextFiredEntity = m_joblessEntityLeader;
+	m_joblessEntityLeader = entity;
 }
 
 //-----------------------------------------------------------------------------------------------
 Entity* EntityManager::HireEntity()
 {
-	Entity* hiredEntity = nullptr;
-	for( unsigned int i = 0; i < m_numEntitiesInPool; ++i )
+	if( m_joblessEntityLeader == nullptr )
 	{
-		Entity& entity = m_entityPool[ i ];
-
-		if( !entity.IsHired() )
-		{
-			hiredEntity = &entity;
-			break;
-		}
+		if( m_growthPolicy == POOL_GROWS_BY_PAGE )
+			AllocateNewPage();
+		else
+			ShowEmptyPoolErrorMessage();
 	}
 
-	if( hiredEntity == nullptr )
-		ShowEmptyPoolErrorMessage();
+	Entity* hiredEntity = m_joblessEntityLeader;
+	m_joblessEntityLeader = hiredEntity->nextFiredEntity;
+	hiredEntity->nextFiredEntity = nullptr;
 
 	hiredEntity->id = s_nextEntityID;
 	++s_nextEntityID;
@@ -72,6 +86,30 @@ Entity* EntityManager::HireEntity()
 
 
 
+//-----------------------------------------------------------------------------------------------
+/* New pages are linked onto the jobless list in index order, so entities are hired from the
+		front of each page first. Existing pages are never reallocated or moved. */
+void EntityManager::AllocateNewPage()
+{
+	Entity* newPage = new Entity[ m_numEntitiesPerPage ];
+	m_entityPages.push_back( newPage );
+	EntityHandle::SlotIndex firstSlotIndexInPage = m_numEntitiesInPool;
+	m_numEntitiesInPool += m_numEntitiesPerPage;
+
+	if( m_transformStore != nullptr )
+		m_transformStore->Resize( m_numEntitiesInPool );
+
+	for( unsigned int i = m_numEntitiesPerPage; i > 0; --i )
+	{
+		Entity& entity = newPage[ i - 1 ];
+		entity.slotIndex = firstSlotIndexInPage + i - 1;
+		entity.transformStore = m_transformStore;
+		entity.archetypeRegistry = &m_archetypeRegistry;
+		entity.nextFiredEntity = m_joblessEntityLeader;
+		m_joblessEntityLeader = &entity;
+	}
+}
+
 //-----------------------------------------------------------------------------------------------
 /* This function has been separated so that includers of EntityManager don't need to know about
 		assertions or string conversion. */
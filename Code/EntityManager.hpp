@@ -9,21 +9,65 @@
 
 
 //-----------------------------------------------------------------------------------------------
-typedef const Entity* ConstEntityIterator;
+/* Walks every entity slot in the pool (hired or not), page by page.
+	Pages are never moved once allocated, so entity pointers stay valid while iterating. */
+class ConstEntityIterator
+{
+	friend class EntityManager;
+
+	ConstEntityIterator( const std::vector< Entity* >* entityPages, size_t entitiesPerPage, size_t slotIndex );
+
+public:
+	//Operators
+	const Entity& operator*() const { return *GetCurrentEntity(); }
+	const Entity* operator->() const { return GetCurrentEntity(); }
+	ConstEntityIterator& operator++() { ++m_slotIndex; return *this; }
+	bool operator==( const ConstEntityIterator& rhs ) const { return m_slotIndex == rhs.m_slotIndex; }
+	bool operator!=( const ConstEntityIterator& rhs ) const { return m_slotIndex != rhs.m_slotIndex; }
+
+
+private:
+	const Entity* GetCurrentEntity() const;
+
+	//Data Members
+	const std::vector< Entity* >* m_entityPages;
+	size_t m_entitiesPerPage;
+	size_t m_slotIndex;
+};
+
 
 
 //-----------------------------------------------------------------------------------------------
 class EntityManager
 {
 public:
+	typedef unsigned char PoolGrowthPolicy;
+	static const PoolGrowthPolicy POOL_FIXED_SIZE = 0;
+	static const PoolGrowthPolicy POOL_GROWS_BY_PAGE = 1;
+
+	typedef unsigned char TransformStoragePolicy;
+	static const TransformStoragePolicy TRANSFORMS_IN_ENTITIES = 0;
+	static const TransformStoragePolicy TRANSFORMS_IN_STORE = 1;
+
 	//Entity Management
 	void FireEntity( Entity* entity );
 	Entity* HireEntity();
 	void QueueEntityForFiring( Entity* entity );
 
+	//Handles
+	Entity* ResolveHandle( const EntityHandle& handle ) const;
+	bool HandleIsValid( const EntityHandle& handle ) const { return ( ResolveHandle( handle ) != nullptr ); }
+
 	//Iteration
-	ConstEntityIterator GetPoolStart() { return &m_entityPool[0]; }
-	ConstEntityIterator GetPoolEnd() { return &m_entityPool[ m_numEntitiesInPool ]; }
+	ConstEntityIterator GetPoolStart() const { return ConstEntityIterator( &m_entityPages, m_numEntitiesPerPage, 0 ); }
+	ConstEntityIterator GetPoolEnd() const { return ConstEntityIterator( &m_entityPages, m_numEntitiesPerPage, m_numEntitiesInPool ); }
+	size_t GetNumberOfEntitiesInPool() const { return m_numEntitiesInPool; }
+
+	//Archetypes (see ComponentQuery)
+	const ArchetypeRegistry& GetArchetypeRegistry() const { return m_archetypeRegistry; }
+
+	//Returns nullptr unless the manager was created with TRANSFORMS_IN_STORE
+	EntityTransformStore* GetTransformStore() const { return m_transformStore; }
 
 
 private:
@@ -32,7 +76,8 @@ private:
 
 
 	//Lifecycle
-	EntityManager( size_t maxEntitiesInPool );
+	EntityManager( size_t entitiesPerPage, PoolGrowthPolicy growthPolicy = POOL_FIXED_SIZE,
+				   TransformStoragePolicy transformPolicy = TRANSFORMS_IN_ENTITIES );
 	~EntityManager();
 	void DoAtEndOfFrame();
 
@@ -41,36 +86,96 @@ private:
 	EntityManager& operator=( const EntityManager& other );
 
 	//Helpers
+	void AllocateNewPage();
+	Entity* GetEntityInSlot( EntityHandle::SlotIndex slotIndex ) const;
 	void ShowEmptyPoolErrorMessage();
 
 	//Data Members
 	static unsigned int s_nextEntityID;
 
+	PoolGrowthPolicy m_growthPolicy;
+	size_t m_numEntitiesPerPage;
 	size_t m_numEntitiesInPool;
-	Entity* m_entityPool;
+	std::vector< Entity* > m_entityPages;
+	EntityTransformStore* m_transformStore;
+	ArchetypeRegistry m_archetypeRegistry;
 	Entity* m_joblessEntityLeader;
 	std::vector< Entity* > m_entitiesWaitingForFiring;
 };
 
 
 
+#pragma region Iteration
+//-----------------------------------------------------------------------------------------------
+inline ConstEntityIterator::ConstEntityIterator( const std::vector< Entity* >* entityPages, size_t entitiesPerPage, size_t slotIndex )
+	: m_entityPages( entityPages )
+	, m_entitiesPerPage( entitiesPerPage )
+	, m_slotIndex( slotIndex )
+{ }
+
+//-----------------------------------------------------------------------------------------------
+inline const Entity* ConstEntityIterator::GetCurrentEntity() const
+{
+	return &( *m_entityPages )[ m_slotIndex / m_entitiesPerPage ][ m_slotIndex % m_entitiesPerPage ];
+}
+#pragma endregion //Iteration
+
+
+
 #pragma region Lifecycle
 //-----------------------------------------------------------------------------------------------
-inline EntityManager::EntityManager( size_t maxEntitiesInPool )
-	: m_numEntitiesInPool( maxEntitiesInPool )
-	, m_entityPool( new Entity[m_numEntitiesInPool] )
+inline EntityManager::EntityManager( size_t entitiesPerPage, PoolGrowthPolicy growthPolicy,
+									 TransformStoragePolicy transformPolicy )
+	: m_growthPolicy( growthPolicy )
+	, m_numEntitiesPerPage( entitiesPerPage )
+	, m_numEntitiesInPool( 0 )
+	, m_transformStore( nullptr )
 	, m_joblessEntityLeader( nullptr )
-{ }
+{
+	if( transformPolicy == TRANSFORMS_IN_STORE )
+		m_transformStore = new EntityTransformStore();
+
+	AllocateNewPage();
+}
 
 //-----------------------------------------------------------------------------------------------
 inline EntityManager::~EntityManager()
 {
-	delete[] m_entityPool;
+	for( unsigned int i = 0; i < m_entityPages.size(); ++i )
+	{
+		delete[] m_entityPages[ i ];
+	}
+	m_entityPages.clear();
+
+	delete m_transformStore;
 }
 #pragma endregion //Lifecycle
 
 
 
+#pragma region Handles
+//-----------------------------------------------------------------------------------------------
+/* Returns nullptr if the handle is null or the entity it referred to has since been fired. */
+inline Entity* EntityManager::ResolveHandle( const EntityHandle& handle ) const
+{
+	if( handle.slotIndex >= m_numEntitiesInPool )
+		return nullptr;
+
+	Entity* entity = GetEntityInSlot( handle.slotIndex );
+	if( entity->generation != handle.generation || !entity->IsHired() )
+		return nullptr;
+	return entity;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline Entity* EntityManager::GetEntityInSlot( EntityHandle::SlotIndex slotIndex ) const
+{
+	return &m_entityPages[ slotIndex / m_numEntitiesPerPage ][ slotIndex % m_numEntitiesPerPage ];
+}
+#pragma endregion //Handles
+
+
+
 //-----------------------------------------------------------------------------------------------
 inline void EntityManager::QueueEntityForFiring( Entity* entity )
 {
@@ -0,0 +1,100 @@
+#include "EntityTransformStore.hpp"
+
+#include "DebuggerInterface.hpp"
+#include "Entity.hpp"
+#include "TimeInterface.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+void BenchmarkEntityTransformStore( unsigned int numberOfEntities )
+{
+	static const unsigned int NUMBER_OF_STEPS = 100;
+	static const float DELTA_SECONDS = 1.f / 60.f;
+
+	//Before: kinematics stored inside each Entity
+	std::vector< Entity > entities( numberOfEntities );
+	for( unsigned int i = 0; i < numberOfEntities; ++i )
+	{
+		entities[ i ].SetVelocity( FloatVector3( 1.f, 2.f, 3.f ) );
+	}
+
+	double startTimeSeconds = GetCurrentTimeSeconds();
+	for( unsigned int step = 0; step < NUMBER_OF_STEPS; ++step )
+	{
+		for( unsigned int i = 0; i < numberOfEntities; ++i )
+		{
+			Entity& entity = entities[ i ];
+			entity.SetPosition( entity.GetPosition() + entity.GetVelocity() * DELTA_SECONDS );
+		}
+	}
+	double entityFieldSeconds = GetCurrentTimeSeconds() - startTimeSeconds;
+
+	//After: kinematics stored in contiguous channel arrays
+	EntityTransformStore transforms;
+	transforms.Resize( numberOfEntities );
+	for( unsigned int i = 0; i < numberOfEntities; ++i )
+	{
+		transforms.SetVelocity( i, FloatVector3( 1.f, 2.f, 3.f ) );
+	}
+
+	startTimeSeconds = GetCurrentTimeSeconds();
+	for( unsigned int step = 0; step < NUMBER_OF_STEPS; ++step )
+	{
+		float* positionX = &transforms.positionX[ 0 ];
+		float* positionY = &transforms.positionY[ 0 ];
+		float* positionZ = &transforms.positionZ[ 0 ];
+		const float* velocityX = &transforms.velocityX[ 0 ];
+		const float* velocityY = &transforms.velocityY[ 0 ];
+		const float* velocityZ = &transforms.velocityZ[ 0 ];
+		for( unsigned int i = 0; i < numberOfEntities; ++i )
+		{
+			positionX[ i ] += velocityX[ i ] * DELTA_SECONDS;
+			positionY[ i ] += velocityY[ i ] * DELTA_SECONDS;
+			positionZ[ i ] += velocityZ[ i ] * DELTA_SECONDS;
+		}
+	}
+	double storeSeconds = GetCurrentTimeSeconds() - startTimeSeconds;
+
+	PrintfToDebuggerOutput( "Entity integration x%u (%u steps): entity fields %.3f ms, transform store %.3f ms\n",
+		numberOfEntities, NUMBER_OF_STEPS, entityFieldSeconds * 1000.0, storeSeconds * 1000.0 );
+}
+
+
+
+#pragma region Slot Management
+//-----------------------------------------------------------------------------------------------
+void EntityTransformStore::ClearSlot( SlotIndex slot )
+{
+	positionX[ slot ] = positionY[ slot ] = positionZ[ slot ] = 0.f;
+	previousPositionX[ slot ] = previousPositionY[ slot ] = previousPositionZ[ slot ] = 0.f;
+	velocityX[ slot ] = velocityY[ slot ] = velocityZ[ slot ] = 0.f;
+	accelerationX[ slot ] = accelerationY[ slot ] = accelerationZ[ slot ] = 0.f;
+	orientationRoll[ slot ] = orientationPitch[ slot ] = orientationYaw[ slot ] = 0.f;
+	angularVelocityRoll[ slot ] = angularVelocityPitch[ slot ] = angularVelocityYaw[ slot ] = 0.f;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* New slots are zeroed. Note that growing may reallocate the channel arrays, so raw
+	channel pointers must not be held across a resize. */
+void EntityTransformStore::Resize( size_t numberOfSlots )
+{
+	positionX.resize( numberOfSlots, 0.f );
+	positionY.resize( numberOfSlots, 0.f );
+	positionZ.resize( numberOfSlots, 0.f );
+	previousPositionX.resize( numberOfSlots, 0.f );
+	previousPositionY.resize( numberOfSlots, 0.f );
+	previousPositionZ.resize( numberOfSlots, 0.f );
+	velocityX.resize( numberOfSlots, 0.f );
+	velocityY.resize( numberOfSlots, 0.f );
+	velocityZ.resize( numberOfSlots, 0.f );
+	accelerationX.resize( numberOfSlots, 0.f );
+	accelerationY.resize( numberOfSlots, 0.f );
+	accelerationZ.resize( numberOfSlots, 0.f );
+	orientationRoll.resize( numberOfSlots, 0.f );
+	orientationPitch.resize( numberOfSlots, 0.f );
+	orientationYaw.resize( numberOfSlots, 0.f );
+	angularVelocityRoll.resize( numberOfSlots, 0.f );
+	angularVelocityPitch.resize( numberOfSlots, 0.f );
+	angularVelocityYaw.resize( numberOfSlots, 0.f );
+}
+#pragma endregion //Slot Management
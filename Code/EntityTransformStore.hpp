@@ -0,0 +1,119 @@
+#pragma once
+#ifndef INCLUDED_ENTITY_TRANSFORM_STORE_HPP
+#define INCLUDED_ENTITY_TRANSFORM_STORE_HPP
+
+//-----------------------------------------------------------------------------------------------
+#include <vector>
+
+#include "Math/EulerAngles.hpp"
+#include "Math/FloatVector3.hpp"
+#include "EntityHandle.hpp"
+
+//-----------------------------------------------------------------------------------------------
+//Benchmark comparing kinematic integration over Entity fields against the store's arrays
+void BenchmarkEntityTransformStore( unsigned int numberOfEntities = 100000 );
+
+//-----------------------------------------------------------------------------------------------
+/* Structure-of-arrays storage for entity kinematics, indexed by entity pool slot.
+	Each channel is its own contiguous float array so that systems which only touch
+	position and velocity don't pull the rest of the Entity through the cache. */
+class EntityTransformStore
+{
+public:
+	typedef EntityHandle::SlotIndex SlotIndex;
+
+	//Slot Management
+	void ClearSlot( SlotIndex slot );
+	size_t GetNumberOfSlots() const { return positionX.size(); }
+	void Resize( size_t numberOfSlots );
+
+	//Accessors
+	FloatVector3 GetPosition( SlotIndex slot ) const { return FloatVector3( positionX[ slot ], positionY[ slot ], positionZ[ slot ] ); }
+	FloatVector3 GetPreviousPosition( SlotIndex slot ) const { return FloatVector3( previousPositionX[ slot ], previousPositionY[ slot ], previousPositionZ[ slot ] ); }
+	FloatVector3 GetVelocity( SlotIndex slot ) const { return FloatVector3( velocityX[ slot ], velocityY[ slot ], velocityZ[ slot ] ); }
+	FloatVector3 GetAcceleration( SlotIndex slot ) const { return FloatVector3( accelerationX[ slot ], accelerationY[ slot ], accelerationZ[ slot ] ); }
+	EulerAngles GetOrientation( SlotIndex slot ) const { return EulerAngles( orientationRoll[ slot ], orientationPitch[ slot ], orientationYaw[ slot ] ); }
+	EulerAngles GetAngularVelocity( SlotIndex slot ) const { return EulerAngles( angularVelocityRoll[ slot ], angularVelocityPitch[ slot ], angularVelocityYaw[ slot ] ); }
+
+	void SetPosition( SlotIndex slot, const FloatVector3& position );
+	void SetPreviousPosition( SlotIndex slot, const FloatVector3& previousPosition );
+	void SetVelocity( SlotIndex slot, const FloatVector3& velocity );
+	void SetAcceleration( SlotIndex slot, const FloatVector3& acceleration );
+	void SetOrientation( SlotIndex slot, const EulerAngles& orientation );
+	void SetAngularVelocity( SlotIndex slot, const EulerAngles& angularVelocity );
+
+
+	//Data Members
+	std::vector< float > positionX;
+	std::vector< float > positionY;
+	std::vector< float > positionZ;
+	std::vector< float > previousPositionX;
+	std::vector< float > previousPositionY;
+	std::vector< float > previousPositionZ;
+	std::vector< float > velocityX;
+	std::vector< float > velocityY;
+	std::vector< float > velocityZ;
+	std::vector< float > accelerationX;
+	std::vector< float > accelerationY;
+	std::vector< float > accelerationZ;
+	std::vector< float > orientationRoll;
+	std::vector< float > orientationPitch;
+	std::vector< float > orientationYaw;
+	std::vector< float > angularVelocityRoll;
+	std::vector< float > angularVelocityPitch;
+	std::vector< float > angularVelocityYaw;
+};
+
+
+
+#pragma region Accessors
+//-----------------------------------------------------------------------------------------------
+inline void EntityTransformStore::SetPosition( SlotIndex slot, const FloatVector3& position )
+{
+	positionX[ slot ] = position.x;
+	positionY[ slot ] = position.y;
+	positionZ[ slot ] = position.z;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline void EntityTransformStore::SetPreviousPosition( SlotIndex slot, const FloatVector3& previousPosition )
+{
+	previousPositionX[ slot ] = previousPosition.x;
+	previousPositionY[ slot ] = previousPosition.y;
+	previousPositionZ[ slot ] = previousPosition.z;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline void EntityTransformStore::SetVelocity( SlotIndex slot, const FloatVector3& velocity )
+{
+	velocityX[ slot ] = velocity.x;
+	velocityY[ slot ] = velocity.y;
+	velocityZ[ slot ] = velocity.z;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline void EntityTransformStore::SetAcceleration( SlotIndex slot, const FloatVector3& acceleration )
+{
+	accelerationX[ slot ] = acceleration.x;
+	accelerationY[ slot ] = acceleration.y;
+	accelerationZ[ slot ] = acceleration.z;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline void EntityTransformStore::SetOrientation( SlotIndex slot, const EulerAngles& orientation )
+{
+	orientationRoll[ slot ] = orientation.rollDegreesAboutX;
+	orientationPitch[ slot ] = orientation.pitchDegreesAboutY;
+	orientationYaw[ slot ] = orientation.yawDegreesAboutZ;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline void EntityTransformStore::SetAngularVelocity( SlotIndex slot, const EulerAngles& angularVelocity )
+{
+	angularVelocityRoll[ slot ] = angularVelocity.rollDegreesAboutX;
+	angularVelocityPitch[ slot ] = angularVelocity.pitchDegreesAboutY;
+	angularVelocityYaw[ slot ] = angularVelocity.yawDegreesAboutZ;
+}
+#pragma endregion //Accessors
+
+#endif //INCLUDED_ENTITY_TRANSFORM_STORE_HPP
@@ -1,13 +1,238 @@
 #include "EventCourier.hpp"
 
+#include <algorithm>
+#include <map>
+#include <stdio.h>
+
+#include "../DebuggerInterface.hpp"
+#include "../TimeInterface.hpp"
+
 
 //-----------------------------------------------------------------------------------------------
 STATIC EventCourier* EventCourier::s_activeEventCourier = nullptr;
 STATIC EventDataBundle EventCourier::DEFAULT_EVENT_DATA = EventDataBundle();
 
+static const unsigned int INITIAL_EVENT_SLOTS_LOG2 = 6;
+static const size_t INITIAL_QUEUED_EVENTS = 64;
+static const size_t EVENTS_PER_DELIVERY_BATCH = 256; //Events are only grouped by name within a batch
+
+
+
+//-----------------------------------------------------------------------------------------------
+struct EventDispatchBenchmarkObserver
+{
+	EventDispatchBenchmarkObserver() : numberOfEventsReceived( 0 ) { }
+
+	void OnEvent( EventDataBundle& /*eventData*/ ) { ++numberOfEventsReceived; }
+
+	unsigned int numberOfEventsReceived;
+};
+
+//-----------------------------------------------------------------------------------------------
+/* Events are sent in a scattered order over all the names, roughly like a busy frame of hit
+	and footstep events would, so neither lookup gets to stay on one warm path. */
+void BenchmarkEventDispatch( unsigned int numberOfEventNames )
+{
+	static const unsigned int NUMBER_OF_SENDS = 1000000;
+	static const unsigned int NAME_STRIDE = 7919;
+
+	//Event names only point at their text, so the strings have to outlive them
+	std::vector< std::string > eventNameStrings;
+	eventNameStrings.reserve( numberOfEventNames );
+	std::vector< EventName > eventNames;
+	eventNames.reserve( numberOfEventNames );
+	for( unsigned int i = 0; i < numberOfEventNames; ++i )
+	{
+		char eventNameBuffer[ 32 ];
+		sprintf( eventNameBuffer, "BenchmarkEvent%u", i );
+		eventNameStrings.push_back( eventNameBuffer );
+		eventNames.push_back( EventName( eventNameStrings.back().c_str() ) );
+	}
+
+	EventDispatchBenchmarkObserver observer;
+	EventObserver observerDelegate = EventObserver::GenerateFromOneArgFunction< EventDispatchBenchmarkObserver, &EventDispatchBenchmarkObserver::OnEvent >( &observer );
+	EventDataBundle eventData;
+
+	//Before: tree lookup
+	std::map< EventName, std::vector< EventObserver > > eventMapping;
+	for( unsigned int i = 0; i < numberOfEventNames; ++i )
+	{
+		eventMapping[ eventNames[ i ] ].push_back( observerDelegate );
+	}
+
+	double startTimeSeconds = GetCurrentTimeSeconds();
+	for( unsigned int i = 0; i < NUMBER_OF_SENDS; ++i )
+	{
+		std::map< EventName, std::vector< EventObserver > >::iterator eventNameObserverPair = eventMapping.find( eventNames[ ( i * NAME_STRIDE ) % numberOfEventNames ] );
+		if( eventNameObserverPair == eventMapping.end() )
+			continue;
+
+		std::vector< EventObserver >& observersForThisEvent = eventNameObserverPair->second;
+		for( unsigned int j = 0; j < observersForThisEvent.size(); ++j )
+		{
+			observersForThisEvent[ j ]( eventData );
+		}
+	}
+	double mapSeconds = GetCurrentTimeSeconds() - startTimeSeconds;
+
+	//After: hash table lookup
+	EventCourier courier;
+	for( unsigned int i = 0; i < numberOfEventNames; ++i )
+	{
+		courier.DoSubscribeForEvent( eventNames[ i ], observerDelegate );
+	}
+
+	startTimeSeconds = GetCurrentTimeSeconds();
+	for( unsigned int i = 0; i < NUMBER_OF_SENDS; ++i )
+	{
+		courier.DoSendEvent( eventNames[ ( i * NAME_STRIDE ) % numberOfEventNames ], eventData );
+	}
+	double tableSeconds = GetCurrentTimeSeconds() - startTimeSeconds;
+
+	PrintfToDebuggerOutput( "Event dispatch x%u sends over %u names: std::map %.3f ms, hash table %.3f ms (%u events received)\n",
+		NUMBER_OF_SENDS, numberOfEventNames, mapSeconds * 1000.0, tableSeconds * 1000.0, observer.numberOfEventsReceived );
+}
+
+
+
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+//-----------------------------------------------------------------------------------------------
+struct EventCourier::StressTestPostingThread
+{
+	StressTestPostingThread( EventCourier& eventCourier, unsigned int postingThreadIndex, unsigned int eventsToPost,
+							 std::atomic< unsigned int >& finishedThreadCount )
+		: courier( eventCourier ), threadIndex( postingThreadIndex ), numberOfEvents( eventsToPost ), numberOfFinishedThreads( finishedThreadCount ) { }
+
+	void operator()()
+	{
+		for( unsigned int i = 0; i < numberOfEvents; ++i )
+		{
+			EventDataBundle eventData;
+			eventData.SetParameter( "thread", static_cast< int >( threadIndex ) );
+			eventData.SetParameter( "sequence", static_cast< int >( i ) );
+			courier.DoPostEvent( "StressTestEvent", eventData );
+		}
+		numberOfFinishedThreads.fetch_add( 1 );
+	}
+
+	EventCourier& courier;
+	unsigned int threadIndex;
+	unsigned int numberOfEvents;
+	std::atomic< unsigned int >& numberOfFinishedThreads;
+};
+
+//-----------------------------------------------------------------------------------------------
+struct EventPostingStressObserver
+{
+	EventPostingStressObserver( unsigned int numberOfPostingThreads )
+		: nextSequenceByThread( numberOfPostingThreads, 0 ), numberOfEventsReceived( 0 ), numberOfEventsOutOfOrder( 0 ) { }
+
+	void OnEvent( EventDataBundle& eventData )
+	{
+		int threadIndex;
+		int sequence;
+		eventData.GetParameterOrDie( "thread", threadIndex );
+		eventData.GetParameterOrDie( "sequence", sequence );
+
+		if( sequence != nextSequenceByThread[ threadIndex ] )
+			++numberOfEventsOutOfOrder;
+		nextSequenceByThread[ threadIndex ] = sequence + 1;
+		++numberOfEventsReceived;
+	}
+
+	std::vector< int > nextSequenceByThread;
+	unsigned int numberOfEventsReceived;
+	unsigned int numberOfEventsOutOfOrder;
+};
+
+//-----------------------------------------------------------------------------------------------
+/* The calling thread flushes the whole time the posting threads run, the way the main thread would
+	once per frame, so moving events across threads is contended rather than done all at the end. */
+void UnitTestEventPostingUnderContention( unsigned int numberOfPostingThreads, unsigned int eventsPerThread )
+{
+	static const double FLUSH_TIME_BUDGET_SECONDS = 0.001;
+
+	EventCourier courier;
+	EventPostingStressObserver observer( numberOfPostingThreads );
+	courier.DoSubscribeForEvent( "StressTestEvent",
+		EventObserver::GenerateFromOneArgFunction< EventPostingStressObserver, &EventPostingStressObserver::OnEvent >( &observer ) );
+
+	double startTimeSeconds = GetCurrentTimeSeconds();
+	std::atomic< unsigned int > numberOfFinishedThreads( 0 );
+	std::vector< std::thread > postingThreads;
+	for( unsigned int i = 0; i < numberOfPostingThreads; ++i )
+	{
+		postingThreads.push_back( std::thread( EventCourier::StressTestPostingThread( courier, i, eventsPerThread, numberOfFinishedThreads ) ) );
+	}
+
+	unsigned int numberOfFlushes = 0;
+	while( numberOfFinishedThreads.load() < numberOfPostingThreads )
+	{
+		courier.DoFlushQueuedEvents( FLUSH_TIME_BUDGET_SECONDS );
+		++numberOfFlushes;
+	}
+	for( unsigned int i = 0; i < postingThreads.size(); ++i )
+	{
+		postingThreads[ i ].join();
+	}
+
+	do
+	{
+		courier.DoFlushQueuedEvents( FLUSH_TIME_BUDGET_SECONDS );
+		++numberOfFlushes;
+	} while( courier.m_numberOfQueuedEvents > 0 );
+	double elapsedSeconds = GetCurrentTimeSeconds() - startTimeSeconds;
+
+	unsigned int numberOfEventsPosted = numberOfPostingThreads * eventsPerThread;
+	PrintfToDebuggerOutput( "Event posting under contention: %u threads x %u events, %u received (%u out of order) over %u flushes in %.3f ms\n",
+		numberOfPostingThreads, eventsPerThread, observer.numberOfEventsReceived, observer.numberOfEventsOutOfOrder, numberOfFlushes, elapsedSeconds * 1000.0 );
+
+	FATAL_ASSERTION( observer.numberOfEventsReceived == numberOfEventsPosted && observer.numberOfEventsOutOfOrder == 0, "Event Courier Error",
+		"Events posted from other threads were lost or delivered out of order!" );
+}
+#endif //!defined( JOB_SYSTEM_SINGLE_THREADED )
+
 
 
 #pragma region Lifecycle
+//-----------------------------------------------------------------------------------------------
+EventCourier::EventCourier()
+	: m_slotIndexShift( 32 - INITIAL_EVENT_SLOTS_LOG2 )
+	, m_queuedEvents( INITIAL_QUEUED_EVENTS )
+	, m_firstQueuedEvent( 0 )
+	, m_numberOfQueuedEvents( 0 )
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	, m_deliveryThreadID( std::this_thread::get_id() )
+	, m_newestCrossThreadEvent( nullptr )
+	, m_oldestCrossThreadEvent( nullptr )
+#endif
+{
+	EventSlot emptySlot;
+	emptySlot.eventHash = 0;
+	emptySlot.observerList = OBSERVER_LIST_None;
+	m_eventSlots.assign( 1 << INITIAL_EVENT_SLOTS_LOG2, emptySlot );
+
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	//The cross-thread list always holds at least one (already delivered) event, so pushes never see it empty
+	m_oldestCrossThreadEvent = new CrossThreadEvent();
+	m_newestCrossThreadEvent.store( m_oldestCrossThreadEvent );
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Events still waiting to cross threads are dropped undelivered. */
+EventCourier::~EventCourier()
+{
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	while( m_oldestCrossThreadEvent != nullptr )
+	{
+		CrossThreadEvent* deliveredEvent = m_oldestCrossThreadEvent;
+		m_oldestCrossThreadEvent = deliveredEvent->next.load();
+		delete deliveredEvent;
+	}
+#endif
+}
+
 //-----------------------------------------------------------------------------------------------
 STATIC void EventCourier::Startup()
 {
@@ -31,28 +256,124 @@ STATIC void EventCourier::Shutdown()
 
 #pragma region Private Instance Interface
 //-----------------------------------------------------------------------------------------------
+/* Goes through DeliverEvent rather than walking the observer vector directly, since observers
+	subscribing to a new event can grow the table and move every observer list. */
 void EventCourier::DoSendEvent( const EventName& eventName, EventDataBundle& eventData )
 {
-	EventObserverMap::iterator eventNameObserverPair = m_eventMapping.find( eventName );
-	if( eventNameObserverPair == m_eventMapping.end() )
+	ObserverListIndex observerList = FindObserverListForEvent( eventName );
+	if( observerList == OBSERVER_LIST_None )
 	{
 		//TODO: Warn?
 		//No observer list for this event name
 		return;
 	}
-	std::vector< EventObserver >& observersForThisEvent = eventNameObserverPair->second;
 
-	std::vector< EventObserver >::iterator observer;
-	for( observer = observersForThisEvent.begin(); observer != observersForThisEvent.end(); ++observer )
+	DeliverEvent( observerList, eventData );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Observers are looked up by index on every call, so one that subscribes or unsubscribes while
+	the event is being delivered can't leave this loop holding a dangling reference. */
+void EventCourier::DeliverEvent( ObserverListIndex observerList, EventDataBundle& eventData )
+{
+	for( unsigned int i = 0; i < m_observerLists[ observerList ].size(); ++i )
+	{
+		m_observerLists[ observerList ][ i ]( eventData );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void EventCourier::DoPostEvent( const EventName& eventName, EventDataBundle& eventData )
+{
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	if( !IsOnDeliveryThread() )
+	{
+		PushCrossThreadEvent( eventName, eventData );
+		return;
+	}
+#endif
+
+	AddToEventQueue( eventName, eventData );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Events are delivered in batches taken from the front of the queue, each grouped by name. The
+	budget is checked between batches, so a flush costs time in proportion to what it delivers,
+	however large the backlog, and carried-over events are always a contiguous run at the front.
+	At least one batch is delivered per flush, so the queue always drains eventually. */
+void EventCourier::DoFlushQueuedEvents( double timeBudgetSeconds )
+{
+	double deadlineSeconds = GetCurrentTimeSeconds() + timeBudgetSeconds;
+
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	MoveCrossThreadEventsToQueue();
+#endif
+	size_t numberOfEventsLeftInFlush = m_numberOfQueuedEvents;
+
+	do
+	{
+		size_t numberOfEventsInBatch = ( numberOfEventsLeftInFlush < EVENTS_PER_DELIVERY_BATCH ) ? numberOfEventsLeftInFlush : EVENTS_PER_DELIVERY_BATCH;
+		DeliverQueuedEventBatch( numberOfEventsInBatch );
+		numberOfEventsLeftInFlush -= numberOfEventsInBatch;
+	} while( numberOfEventsLeftInFlush > 0 && GetCurrentTimeSeconds() < deadlineSeconds );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Events are grouped by name, and the groups are delivered in the order each name was first
+	posted within the batch, so which name goes first never depends on its hash. Within a group,
+	events keep the order they were posted in.
+
+	Each event's data is moved out of the queue before delivery, since observers posting new
+	events can grow (and so move) the queue. */
+void EventCourier::DeliverQueuedEventBatch( size_t numberOfEventsInBatch )
+{
+	m_deliveryOrder.resize( numberOfEventsInBatch );
+	for( size_t i = 0; i < numberOfEventsInBatch; ++i )
+	{
+		m_deliveryOrder[ i ].eventHash = GetQueuedEvent( i ).name.GetHash();
+		m_deliveryOrder[ i ].queuePosition = i;
+	}
+
+	std::sort( m_deliveryOrder.begin(), m_deliveryOrder.end(), &QueuedEventDeliveryOrder::IsGroupedBefore );
+	for( size_t i = 0; i < numberOfEventsInBatch; ++i )
+	{
+		bool startsNewGroup = ( i == 0 || m_deliveryOrder[ i ].eventHash != m_deliveryOrder[ i - 1 ].eventHash );
+		m_deliveryOrder[ i ].firstQueuePositionForName = startsNewGroup ? m_deliveryOrder[ i ].queuePosition : m_deliveryOrder[ i - 1 ].firstQueuePositionForName;
+	}
+	std::sort( m_deliveryOrder.begin(), m_deliveryOrder.end() );
+
+	ObserverListIndex observerList = OBSERVER_LIST_None;
+	for( size_t i = 0; i < numberOfEventsInBatch; ++i )
 	{
-		(*observer)( eventData );
+		const QueuedEventDeliveryOrder& delivery = m_deliveryOrder[ i ];
+		QueuedEvent& queuedEvent = GetQueuedEvent( delivery.queuePosition );
+		if( i == 0 || delivery.eventHash != m_deliveryOrder[ i - 1 ].eventHash )
+			observerList = FindObserverListForEvent( queuedEvent.name );
+
+		EventDataBundle eventData;
+		eventData.Swap( queuedEvent.eventData );
+		if( observerList != OBSERVER_LIST_None )
+			DeliverEvent( observerList, eventData );
 	}
+
+	m_firstQueuedEvent = ( m_firstQueuedEvent + numberOfEventsInBatch ) % m_queuedEvents.size();
+	m_numberOfQueuedEvents -= numberOfEventsInBatch;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool EventCourier::IsOnDeliveryThread() const
+{
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	return std::this_thread::get_id() == m_deliveryThreadID;
+#else
+	return true;
+#endif
 }
 
 //-----------------------------------------------------------------------------------------------
 void EventCourier::DoSubscribeForEvent( const EventName& eventName, const EventObserver& observer )
 {
-	std::vector< EventObserver >& observersForThisEvent = m_eventMapping[ eventName ];
+	std::vector< EventObserver >& observersForThisEvent = FindOrAddObserversForEvent( eventName );
 
 	bool observerNotAlreadySubscribed = true;
 	std::vector< EventObserver >::iterator observerInArray;
@@ -77,23 +398,196 @@ void EventCourier::DoSubscribeForEvent( const EventName& eventName, const EventO
 //-----------------------------------------------------------------------------------------------
 void EventCourier::DoUnsubscribeFromEvent( const EventName& eventName, const EventObserver& observer )
 {
-	EventObserverMap::iterator eventNameObserverPair = m_eventMapping.find( eventName );
-	if( eventNameObserverPair == m_eventMapping.end() )
+	std::vector< EventObserver >* observersForThisEvent = FindObserversForEvent( eventName );
+	if( observersForThisEvent == nullptr )
 	{
 		//TODO: Warn?
 		//No observer list for this event name
 		return;
 	}
-	std::vector< EventObserver >& observersForThisEvent = eventNameObserverPair->second;
 
 	std::vector< EventObserver >::iterator observerInArray;
-	for(	observerInArray = observersForThisEvent.begin(); 
-			observerInArray != observersForThisEvent.end(); )
+	for(	observerInArray = observersForThisEvent->begin(); 
+			observerInArray != observersForThisEvent->end(); )
 	{
 		if( *observerInArray == observer )
-			observerInArray = observersForThisEvent.erase( observerInArray );
+			observerInArray = observersForThisEvent->erase( observerInArray );
 		else
 			++observerInArray;
 	}
 }
 #pragma endregion //Private Instance Interface
+
+
+
+#pragma region Event Table
+//-----------------------------------------------------------------------------------------------
+/* Fibonacci hashing: the multiply mixes every bit of the hash into the top bits, which become the slot. */
+unsigned int EventCourier::GetFirstSlotForHash( EventName::Hash eventHash ) const
+{
+	return ( eventHash * 2654435769u ) >> m_slotIndexShift;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Linear probing. Slots are never emptied (an event whose observers all unsubscribe keeps its
+	empty list), so the first empty slot ends the search. */
+EventCourier::ObserverListIndex EventCourier::FindObserverListForEvent( const EventName& eventName ) const
+{
+	EventName::Hash eventHash = eventName.GetHash();
+	unsigned int slotMask = m_eventSlots.size() - 1;
+	for( unsigned int slot = GetFirstSlotForHash( eventHash ); ; slot = ( slot + 1 ) & slotMask )
+	{
+		const EventSlot& eventSlot = m_eventSlots[ slot ];
+		if( eventSlot.observerList == OBSERVER_LIST_None || eventSlot.eventHash == eventHash )
+			return eventSlot.observerList;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+std::vector< EventObserver >* EventCourier::FindObserversForEvent( const EventName& eventName )
+{
+	ObserverListIndex observerList = FindObserverListForEvent( eventName );
+	if( observerList == OBSERVER_LIST_None )
+		return nullptr;
+	return &m_observerLists[ observerList ];
+}
+
+//-----------------------------------------------------------------------------------------------
+std::vector< EventObserver >& EventCourier::FindOrAddObserversForEvent( const EventName& eventName )
+{
+	std::vector< EventObserver >* existingObservers = FindObserversForEvent( eventName );
+	if( existingObservers != nullptr )
+		return *existingObservers;
+
+	if( ( m_observerLists.size() + 1 ) * 2 > m_eventSlots.size() )
+		GrowEventTable();
+
+	EventName::Hash eventHash = eventName.GetHash();
+	unsigned int slotMask = m_eventSlots.size() - 1;
+	unsigned int slot = GetFirstSlotForHash( eventHash );
+	while( m_eventSlots[ slot ].observerList != OBSERVER_LIST_None )
+	{
+		slot = ( slot + 1 ) & slotMask;
+	}
+
+	m_eventSlots[ slot ].eventHash = eventHash;
+	m_eventSlots[ slot ].observerList = static_cast< ObserverListIndex >( m_observerLists.size() );
+	m_observerLists.push_back( std::vector< EventObserver >() );
+	return m_observerLists.back();
+}
+
+//-----------------------------------------------------------------------------------------------
+void EventCourier::GrowEventTable()
+{
+	std::vector< EventSlot > oldSlots;
+	oldSlots.swap( m_eventSlots );
+
+	EventSlot emptySlot;
+	emptySlot.eventHash = 0;
+	emptySlot.observerList = OBSERVER_LIST_None;
+	m_eventSlots.assign( oldSlots.size() * 2, emptySlot );
+	--m_slotIndexShift;
+
+	unsigned int slotMask = m_eventSlots.size() - 1;
+	for( unsigned int i = 0; i < oldSlots.size(); ++i )
+	{
+		if( oldSlots[ i ].observerList == OBSERVER_LIST_None )
+			continue;
+
+		unsigned int slot = GetFirstSlotForHash( oldSlots[ i ].eventHash );
+		while( m_eventSlots[ slot ].observerList != OBSERVER_LIST_None )
+		{
+			slot = ( slot + 1 ) & slotMask;
+		}
+		m_eventSlots[ slot ] = oldSlots[ i ];
+	}
+}
+#pragma endregion //Event Table
+
+
+
+#pragma region Event Queue
+//-----------------------------------------------------------------------------------------------
+STATIC bool EventCourier::QueuedEventDeliveryOrder::IsGroupedBefore( const QueuedEventDeliveryOrder& first, const QueuedEventDeliveryOrder& second )
+{
+	if( first.eventHash != second.eventHash )
+		return first.eventHash < second.eventHash;
+	return first.queuePosition < second.queuePosition;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool EventCourier::QueuedEventDeliveryOrder::operator<( const QueuedEventDeliveryOrder& other ) const
+{
+	if( firstQueuePositionForName != other.firstQueuePositionForName )
+		return firstQueuePositionForName < other.firstQueuePositionForName;
+	return queuePosition < other.queuePosition;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Free slots in the queue always hold empty bundles, so swapping leaves eventData empty. */
+void EventCourier::AddToEventQueue( const EventName& eventName, EventDataBundle& eventData )
+{
+	if( m_numberOfQueuedEvents == m_queuedEvents.size() )
+		GrowEventQueue();
+
+	QueuedEvent& newEvent = GetQueuedEvent( m_numberOfQueuedEvents );
+	newEvent.name = eventName;
+	newEvent.eventData.Swap( eventData );
+	++m_numberOfQueuedEvents;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Queued events keep their offsets from the front of the queue, so a flush in progress can
+	keep using them after the queue grows. */
+void EventCourier::GrowEventQueue()
+{
+	std::vector< QueuedEvent > grownQueue( m_queuedEvents.size() * 2 );
+	for( size_t i = 0; i < m_numberOfQueuedEvents; ++i )
+	{
+		QueuedEvent& queuedEvent = GetQueuedEvent( i );
+		grownQueue[ i ].name = queuedEvent.name;
+		grownQueue[ i ].eventData.Swap( queuedEvent.eventData );
+	}
+
+	m_queuedEvents.swap( grownQueue );
+	m_firstQueuedEvent = 0;
+}
+#pragma endregion //Event Queue
+
+
+
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+#pragma region Cross-Thread Posting
+//-----------------------------------------------------------------------------------------------
+/* A linked list of events, oldest first, that any number of threads push onto with one atomic
+	exchange each: a pusher swaps its event in as the newest, then links the previous newest to it.
+	Between those two steps the list looks like it ends early, so the delivery thread just stops
+	there and picks up the rest on the next flush. No event is ever lost, and each thread's events
+	arrive in the order it posted them. */
+void EventCourier::PushCrossThreadEvent( const EventName& eventName, EventDataBundle& eventData )
+{
+	CrossThreadEvent* newEvent = new CrossThreadEvent();
+	newEvent->name = eventName;
+	newEvent->eventData.Swap( eventData );
+
+	CrossThreadEvent* previousNewestEvent = m_newestCrossThreadEvent.exchange( newEvent, std::memory_order_acq_rel );
+	previousNewestEvent->next.store( newEvent, std::memory_order_release );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* The oldest event in the list has always been moved already; once its successor has been moved
+	too, the successor takes its place and it can be freed. */
+void EventCourier::MoveCrossThreadEventsToQueue()
+{
+	CrossThreadEvent* nextEvent = m_oldestCrossThreadEvent->next.load( std::memory_order_acquire );
+	while( nextEvent != nullptr )
+	{
+		AddToEventQueue( nextEvent->name, nextEvent->eventData );
+
+		delete m_oldestCrossThreadEvent;
+		m_oldestCrossThreadEvent = nextEvent;
+		nextEvent = m_oldestCrossThreadEvent->next.load( std::memory_order_acquire );
+	}
+}
+#pragma endregion //Cross-Thread Posting
+#endif //!defined( JOB_SYSTEM_SINGLE_THREADED )
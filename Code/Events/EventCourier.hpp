@@ -3,24 +3,98 @@
 #define INCLUDED_EVENT_COURIER_HPP
 
 //-----------------------------------------------------------------------------------------------
-#include <map>
 #include <vector>
 
 #include "../AssertionError.hpp"
 #include "../Delegate.hpp"
 #include "../EngineMacros.hpp"
+#include "../JobSystem.hpp"
 #include "../NamedDataBundle.hpp"
 
-typedef HashedString EventName;
+typedef HashedStringView EventName;
 typedef NamedDataBundle EventDataBundle;
 typedef Delegate< void, EventDataBundle > EventObserver;
 
+//-----------------------------------------------------------------------------------------------
+//Benchmark of event dispatch through the courier's hash table against the old std::map lookup
+void BenchmarkEventDispatch( unsigned int numberOfEventNames = 1000 );
+
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+//-----------------------------------------------------------------------------------------------
+//Many threads posting events at once; dies if any event is lost or reordered
+void UnitTestEventPostingUnderContention( unsigned int numberOfPostingThreads = 8, unsigned int eventsPerThread = 100000 );
+#endif
+
 
 //-----------------------------------------------------------------------------------------------
+/* Observers are found through an open-addressing hash table keyed on each event name's
+	precomputed hash, so sending an event costs a hash mix and (almost always) a single probe.
+	Like the std::map it replaced, the table compares only hashes, not strings.
+
+	SendEvent delivers immediately. PostEvent instead queues the event, with its data, until the
+	next FlushQueuedEvents (once per frame, from GameInterface::DoAtEndOfFrame). A flush delivers
+	the events that were queued when it started, in batches of up to 256 taken from the front of
+	the queue. Each batch is grouped by name so each observer list is walked in one go; names are
+	delivered in the order they were first posted within the batch, and events with the same name
+	keep the order they were posted in. Grouping never reaches across batches, so a name with events
+	in several batches has its observers walked once per batch, and all of one batch's events are
+	delivered before any of the next one's. Events posted while flushing wait for the next flush,
+	so cascades can't run away within a frame, and whatever doesn't fit in the flush's time budget
+	carries over too.
+
+	PostEvent is the only call that's safe from any thread. Posts from the thread that started the
+	courier go straight into the queue; posts from other threads are pushed, without locking, onto
+	a multiple-producer list that the next flush moves into the queue. Everything else, including
+	delivery, happens on the thread that started the courier. */
 SINGLETON class EventCourier
 {
+	friend void BenchmarkEventDispatch( unsigned int numberOfEventNames );
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	friend void UnitTestEventPostingUnderContention( unsigned int numberOfPostingThreads, unsigned int eventsPerThread );
+#endif
+
 private:
-	typedef std::map< EventName, std::vector< EventObserver > > EventObserverMap;
+	typedef unsigned int ObserverListIndex;
+	static const ObserverListIndex OBSERVER_LIST_None = 0xffffffff;
+
+	//-------------------------------------------------------------------------------------------
+	struct EventSlot
+	{
+		EventName::Hash eventHash;
+		ObserverListIndex observerList; //OBSERVER_LIST_None when the slot is empty
+	};
+
+	//-------------------------------------------------------------------------------------------
+	struct QueuedEvent
+	{
+		EventName name;
+		EventDataBundle eventData;
+	};
+
+	//-------------------------------------------------------------------------------------------
+	struct QueuedEventDeliveryOrder
+	{
+		static bool IsGroupedBefore( const QueuedEventDeliveryOrder& first, const QueuedEventDeliveryOrder& second );
+		bool operator<( const QueuedEventDeliveryOrder& other ) const;
+
+		EventName::Hash eventHash;
+		size_t queuePosition; //Offset from the front of the queue
+		size_t firstQueuePositionForName; //Where the batch's first event with this name was
+	};
+
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	//-------------------------------------------------------------------------------------------
+	struct CrossThreadEvent
+	{
+		CrossThreadEvent() : next( nullptr ) { }
+
+		EventName name;
+		EventDataBundle eventData;
+		std::atomic< CrossThreadEvent* > next;
+	};
+
+	struct StressTestPostingThread;
+#endif
 
 
 public:
@@ -32,6 +106,12 @@ public:
 	static void SendEvent( const EventName& eventName );
 	static void SendEvent( const EventName& eventName, EventDataBundle& eventData );
 
+	//The courier takes eventData's parameters, leaving it empty
+	static void PostEvent( const EventName& eventName );
+	static void PostEvent( const EventName& eventName, EventDataBundle& eventData );
+	static void FlushQueuedEvents( double timeBudgetSeconds );
+	static size_t GetNumberOfQueuedEvents();
+
 	static void SubscribeForEvent( const EventName& eventName, const EventObserver& observer );
 	static void UnsubscribeFromEvent( const EventName& eventName, const EventObserver& observer );
 	
@@ -40,11 +120,17 @@ public:
 
 
 private:
-	EventCourier() { }
-	~EventCourier() { }
+	EventCourier();
+	~EventCourier();
 
 	//Private Instance Interface
 	void DoSendEvent( const EventName& eventName, EventDataBundle& eventData );
+	void DeliverEvent( ObserverListIndex observerList, EventDataBundle& eventData );
+
+	void DoPostEvent( const EventName& eventName, EventDataBundle& eventData );
+	void DoFlushQueuedEvents( double timeBudgetSeconds );
+	void DeliverQueuedEventBatch( size_t numberOfEventsInBatch );
+	bool IsOnDeliveryThread() const;
 
 	void DoSubscribeForEvent( const EventName& eventName, const EventObserver& observer );
 	void DoUnsubscribeFromEvent( const EventName& eventName, const EventObserver& observer );
@@ -52,12 +138,42 @@ private:
 	template<typename EventSubscriber>
 	void DoUnsubscribeFromAllEvents( const EventSubscriber* subscriber );
 
+	//Event Table
+	unsigned int GetFirstSlotForHash( EventName::Hash eventHash ) const;
+	ObserverListIndex FindObserverListForEvent( const EventName& eventName ) const;
+	std::vector< EventObserver >* FindObserversForEvent( const EventName& eventName );
+	std::vector< EventObserver >& FindOrAddObserversForEvent( const EventName& eventName );
+	void GrowEventTable();
+
+	//Event Queue
+	QueuedEvent& GetQueuedEvent( size_t queuePosition ) { return m_queuedEvents[ ( m_firstQueuedEvent + queuePosition ) % m_queuedEvents.size() ]; }
+	void AddToEventQueue( const EventName& eventName, EventDataBundle& eventData );
+	void GrowEventQueue();
+
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	void PushCrossThreadEvent( const EventName& eventName, EventDataBundle& eventData );
+	void MoveCrossThreadEventsToQueue();
+#endif
+
 	//Static Members
 	static EventCourier* s_activeEventCourier;
 	static EventDataBundle DEFAULT_EVENT_DATA;
 
 	//Data Members
-	EventObserverMap m_eventMapping;
+	std::vector< EventSlot > m_eventSlots; //Power of two in size, and never more than half full
+	unsigned int m_slotIndexShift;
+	std::vector< std::vector< EventObserver > > m_observerLists;
+
+	std::vector< QueuedEvent > m_queuedEvents; //Ring buffer
+	size_t m_firstQueuedEvent;
+	size_t m_numberOfQueuedEvents;
+	std::vector< QueuedEventDeliveryOrder > m_deliveryOrder;
+
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	std::thread::id m_deliveryThreadID;
+	std::atomic< CrossThreadEvent* > m_newestCrossThreadEvent; //Producers push here
+	CrossThreadEvent* m_oldestCrossThreadEvent; //Already delivered; its successor is the next to move
+#endif
 };
 
 
@@ -81,6 +197,45 @@ STATIC inline void EventCourier::SendEvent( const EventName& eventName, EventDat
 	s_activeEventCourier->DoSendEvent( eventName, eventData );
 }
 
+//-----------------------------------------------------------------------------------------------
+STATIC inline void EventCourier::PostEvent( const EventName& eventName )
+{
+	FATAL_ASSERTION( s_activeEventCourier != nullptr, "Event Courier Error",
+		"The event courier was used without being started up!" );
+
+	EventDataBundle noEventData;
+	s_activeEventCourier->DoPostEvent( eventName, noEventData );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC inline void EventCourier::PostEvent( const EventName& eventName, EventDataBundle& eventData )
+{
+	FATAL_ASSERTION( s_activeEventCourier != nullptr, "Event Courier Error",
+		"The event courier was used without being started up!" );
+
+	s_activeEventCourier->DoPostEvent( eventName, eventData );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC inline void EventCourier::FlushQueuedEvents( double timeBudgetSeconds )
+{
+	FATAL_ASSERTION( s_activeEventCourier != nullptr, "Event Courier Error",
+		"The event courier was used without being started up!" );
+	FATAL_ASSERTION( s_activeEventCourier->IsOnDeliveryThread(), "Event Courier Error",
+		"Queued events can only be flushed from the thread that started the event courier!" );
+
+	s_activeEventCourier->DoFlushQueuedEvents( timeBudgetSeconds );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC inline size_t EventCourier::GetNumberOfQueuedEvents()
+{
+	FATAL_ASSERTION( s_activeEventCourier != nullptr, "Event Courier Error",
+		"The event courier was used without being started up!" );
+
+	return s_activeEventCourier->m_numberOfQueuedEvents;
+}
+
 //-----------------------------------------------------------------------------------------------
 STATIC inline void EventCourier::SubscribeForEvent( const EventName& eventName, const EventObserver& observer )
 {
@@ -96,7 +251,7 @@ STATIC inline void EventCourier::UnsubscribeFromEvent( const EventName& eventNam
 	FATAL_ASSERTION( s_activeEventCourier != nullptr, "Event Courier Error",
 		"The event courier was used without being started up!" );
 
-	s_activeEventCourier->DoSubscribeForEvent( eventName, observer );
+	s_activeEventCourier->DoUnsubscribeFromEvent( eventName, observer );
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -114,12 +269,9 @@ STATIC inline void EventCourier::UnsubscribeFromAllEvents( const EventSubscriber
 template<typename EventSubscriber>
 void EventCourier::DoUnsubscribeFromAllEvents( const EventSubscriber* subscriber )
 {
-	EventObserverMap::iterator eventNameObserverPair;
-	for( eventNameObserverPair = m_eventMapping.begin(); 
-		eventNameObserverPair != m_eventMapping.end(); 
-		++eventNameObserverPair )
+	for( unsigned int i = 0; i < m_observerLists.size(); ++i )
 	{
-		std::vector< EventObserver >& observerArray = eventNameObserverPair->second;
+		std::vector< EventObserver >& observerArray = m_observerLists[ i ];
 		std::vector< EventObserver >::iterator observer;
 		
 		for( observer = observerArray.begin(); observer != observerArray.end(); )
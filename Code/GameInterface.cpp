@@ -1,6 +1,7 @@
 #include "GameInterface.hpp"
 
 #include "EntityManager.hpp"
+#include "SystemManager.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -11,6 +12,7 @@ STATIC bool GameInterface::s_engineShouldShutdown = false;
 
 //-----------------------------------------------------------------------------------------------
 GameInterface::GameInterface()
+	: m_queuedEventTimeBudgetSeconds( 0.002 )
 {
 #if defined( PLATFORM_ANDROID )
 	app_dummy();
@@ -18,18 +20,40 @@ GameInterface::GameInterface()
 
 	s_gameInstancePointer = this;
 
-	m_activeEntityManager = new EntityManager( 100 );
+	m_activeEntityManager = new EntityManager( 100, EntityManager::POOL_GROWS_BY_PAGE );
+	m_activeSystemManager = new SystemManager();
 }
 
 //-----------------------------------------------------------------------------------------------
+STATIC void GameInterface::Update( float deltaSeconds )
+{
+	s_gameInstancePointer->m_activeSystemManager->UpdateSystems( deltaSeconds );
+	s_gameInstancePointer->DoUpdate( deltaSeconds );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC void GameInterface::Render()
+{
+	s_gameInstancePointer->m_activeSystemManager->RenderSystems();
+	s_gameInstancePointer->DoRender();
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Posted events are delivered first and queued entities are fired next, so the components
+	either of them flag for deletion are swept by the systems this frame rather than simulated
+	for one more. */
 VIRTUAL void GameInterface::DoAtEndOfFrame()
 {
+	EventCourier::FlushQueuedEvents( m_queuedEventTimeBudgetSeconds );
 	m_activeEntityManager->DoAtEndOfFrame();
+	m_activeSystemManager->EndFrame();
 }
 
 //-----------------------------------------------------------------------------------------------
 VIRTUAL void GameInterface::DoBeforeEngineDestruction()
 {
+	//Systems may still hold components attached to entities, so they go first
+	delete m_activeSystemManager;
 	delete m_activeEntityManager;
 
 	EventCourier::UnsubscribeFromAllEvents( this );
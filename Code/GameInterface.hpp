@@ -6,6 +6,7 @@
 #include "Events/EventCourier.hpp"
 #include "EngineMacros.hpp"
 #include "EntityManager.hpp"
+#include "SystemManager.hpp"
 
 /* These pragma comments are needed in order to force the compiler to link needed engine libraries in.
  * GameInterface is guaranteed to be used by the game, so these comment linkages will get rolled in.*/
@@ -51,6 +52,10 @@ private:
 protected:
 	//These "systems" are so often needed by other systems and blueprints that they are now standard.
 	EntityManager* m_activeEntityManager;
+	SystemManager* m_activeSystemManager;
+
+	//How long the end of each frame may spend delivering posted events before the rest carry over
+	double m_queuedEventTimeBudgetSeconds;
 
 	virtual ~GameInterface() { }
 
@@ -74,8 +79,9 @@ public:
 	static void BeforeEngineInitialization() { s_gameInstancePointer->DoBeforeEngineInitialization(); }
 	static void BeforeFirstFrame( unsigned int windowWidth, unsigned int windowHeight ) { s_gameInstancePointer->DoBeforeFirstFrame( windowWidth, windowHeight ); }
 
-	static void Update( float deltaSeconds ) { s_gameInstancePointer->DoUpdate( deltaSeconds ); }
-	static void Render() { s_gameInstancePointer->DoRender(); }
+	//Registered systems go before the game's own update and render, so the game can draw over them
+	static void Update( float deltaSeconds );
+	static void Render();
 	static void EndOfFrame() { s_gameInstancePointer->DoAtEndOfFrame(); }
 
 	static void BeforeEngineDestruction() { s_gameInstancePointer->DoBeforeEngineDestruction(); }
@@ -84,5 +90,6 @@ public:
 	//Accessors
 	static bool EngineShouldShutdown() { return s_engineShouldShutdown; }
 	static EntityManager& GetEntityManager() { return *s_gameInstancePointer->m_activeEntityManager; }
+	static SystemManager& GetSystemManager() { return *s_gameInstancePointer->m_activeSystemManager; }
 };
 #endif //INCLUDED_GAME_INTERFACE_HPP
@@ -12,6 +12,7 @@
 #include "../Math/Float4x4Matrix.hpp"
 #include "../Math/IntVector2.hpp"
 #include "RendererInterface.hpp"
+#include "ShaderReflection.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -69,9 +70,11 @@ public:
 	virtual void DisableAttributeVariableInShader( const ShaderVariable* variable ) = 0;
 	virtual void EnableAttributeVariableInShader( const ShaderVariable* variable ) = 0;
 	virtual ShaderVariable* GetAttributeVariable( const ShaderPipeline* pipeline, const char* attributeName ) = 0;
+	virtual int GetAttributeVariableSlot( const ShaderVariable* variable ) const = 0; //-1 if it has no generic attribute slot
 	virtual int GetNumberOfAttributesInPipeline( const ShaderPipeline* pipeline ) const = 0;
 	virtual int GetNumberOfUniformsInPipeline( const ShaderPipeline* pipeline ) const = 0;
 	virtual ShaderVariable* GetUniformVariable( const ShaderPipeline* pipeline, const char* uniformName ) = 0;
+	virtual const ShaderReflection& GetPipelineReflection( const ShaderPipeline* pipeline ) const = 0;
 	virtual void LoadSourceFromFileOrDie( char*& out_shaderData, const char* fileName ) = 0;
 	virtual void SetTextureUnitUniform( ShaderVariable* variable, unsigned int samplerUnitNumber ) = 0;
 	virtual void SetUniform( ShaderVariable* variable, int integer ) = 0;
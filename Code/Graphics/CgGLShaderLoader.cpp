@@ -59,6 +59,12 @@ CgGLShaderLoader::~CgGLShaderLoader()
 		delete m_pipelineCache[ i ];
 	}
 	m_pipelineCache.clear();
+
+	for( unsigned int i = 0; i < m_reflectedVariables.size(); ++i )
+	{
+		delete m_reflectedVariables[ i ];
+	}
+	m_reflectedVariables.clear();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -184,6 +190,7 @@ ShaderPipeline* CgGLShaderLoader::CreateOrGetPipelineFromShaders( const Shader*
 	DetachShaderFromPipeline( newPipeline->vertexShader, newPipeline );
 	DetachShaderFromPipeline( newPipeline->fragmentShader, newPipeline );
 
+	ReflectPipeline( newPipeline );
 	m_pipelineCache.push_back( newPipeline );
 	return newPipeline;
 }
@@ -192,6 +199,7 @@ ShaderPipeline* CgGLShaderLoader::CreateOrGetPipelineFromShaders( const Shader*
 void CgGLShaderLoader::DeletePipelineDataOnCard( ShaderPipeline* pipeline )
 {
 	cgDestroyProgram( pipeline->combinedProgram );
+	RendererInterface::ForgetCachedState();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -255,6 +263,17 @@ ShaderVariable* CgGLShaderLoader::GetAttributeVariable( const ShaderPipeline* pi
 	return newVariable;
 }
 
+//-----------------------------------------------------------------------------------------------
+int CgGLShaderLoader::GetAttributeVariableSlot( const ShaderVariable* variable ) const
+{
+	static const int NUMBER_OF_GENERIC_ATTRIBUTE_RESOURCES = 16;
+
+	int attributeSlot = cgGetParameterResource( variable->parameter ) - CG_ATTR0;
+	if( attributeSlot < 0 || attributeSlot >= NUMBER_OF_GENERIC_ATTRIBUTE_RESOURCES )
+		return -1;
+	return attributeSlot;
+}
+
 //-----------------------------------------------------------------------------------------------
 int CgGLShaderLoader::GetNumberOfAttributesInPipeline( const ShaderPipeline* pipeline ) const
 {
@@ -429,6 +448,40 @@ void CgGLShaderLoader::VerifyNoCgErrorsHaveOccurredOrDie()
 		FATAL_ERROR( "CgGL Shader Loader Error", errorText );
 	}
 }
+
+//-----------------------------------------------------------------------------------------------
+/* The vertex program is walked first so that, like GetUniformVariable, a uniform declared in
+	both programs resolves to the vertex program's parameter. */
+void CgGLShaderLoader::ReflectPipeline( ShaderPipeline* pipeline )
+{
+	static const bool INCLUDE_VERTEX_INPUTS = true;
+
+	ReflectProgramParameters( pipeline->vertexShader->shaderPointer, INCLUDE_VERTEX_INPUTS, pipeline->reflection );
+	ReflectProgramParameters( pipeline->fragmentShader->shaderPointer, !INCLUDE_VERTEX_INPUTS, pipeline->reflection );
+	VerifyNoCgErrorsHaveOccurredOrDie();
+
+	pipeline->reflection.FinishBuilding();
+}
+
+//-----------------------------------------------------------------------------------------------
+void CgGLShaderLoader::ReflectProgramParameters( CGprogram program, bool includeVertexInputs, ShaderReflection& out_reflection )
+{
+	for( CGparameter parameter = cgGetFirstLeafParameter( program, CG_PROGRAM ); parameter != nullptr; parameter = cgGetNextLeafParameter( parameter ) )
+	{
+		if( cgGetParameterVariability( parameter ) == CG_UNIFORM )
+		{
+			ShaderVariable* uniform = new ShaderVariable( parameter );
+			m_reflectedVariables.push_back( uniform );
+			out_reflection.AddUniform( cgGetParameterName( parameter ), uniform );
+		}
+		else if( includeVertexInputs && cgGetParameterVariability( parameter ) == CG_VARYING && cgGetParameterDirection( parameter ) == CG_IN )
+		{
+			ShaderVariable* attribute = new ShaderVariable( parameter );
+			m_reflectedVariables.push_back( attribute );
+			out_reflection.AddAttribute( cgGetParameterName( parameter ), attribute );
+		}
+	}
+}
 #pragma endregion //Helpers
 
 #endif //defined( SHADER_LOADER_USING_CG )
\ No newline at end of file
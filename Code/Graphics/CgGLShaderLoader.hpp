@@ -57,6 +57,7 @@ struct ShaderPipeline
 	const Shader* geometryShader;
 	const Shader* fragmentShader;
 	CGprogram combinedProgram;
+	ShaderReflection reflection;
 };
 
 
@@ -90,9 +91,11 @@ public:
 	void DisableAttributeVariableInShader( const ShaderVariable* variable );
 	void EnableAttributeVariableInShader( const ShaderVariable* variable );
 	ShaderVariable* GetAttributeVariable( const ShaderPipeline* pipeline, const char* attributeName );
+	int GetAttributeVariableSlot( const ShaderVariable* variable ) const;
 	int GetNumberOfAttributesInPipeline( const ShaderPipeline* pipeline ) const;
 	int GetNumberOfUniformsInPipeline( const ShaderPipeline* pipeline ) const;
 	ShaderVariable* GetUniformVariable( const ShaderPipeline* pipeline, const char* uniformName );
+	const ShaderReflection& GetPipelineReflection( const ShaderPipeline* pipeline ) const { return pipeline->reflection; }
 	void LoadSourceFromFileOrDie( char*& out_shaderData, const char* fileName );
 	void SetTextureUnitUniform( ShaderVariable* variable, unsigned int samplerUnitNumber );
 	void SetUniform( ShaderVariable* variable, int integer );
@@ -110,10 +113,13 @@ private:
 	CGerror GetCGErrorCode();
 	const char* GetCGErrorString( CGerror errorCode );
 	void VerifyNoCgErrorsHaveOccurredOrDie();
+	void ReflectPipeline( ShaderPipeline* pipeline );
+	void ReflectProgramParameters( CGprogram program, bool includeVertexInputs, ShaderReflection& out_reflection );
 
 	//Data Members
 	CGcontext m_shaderContainer;
 	std::vector< ShaderPipeline* > m_pipelineCache;
+	std::vector< ShaderVariable* > m_reflectedVariables;
 	std::map< std::string, Shader > m_shaderCache;
 };
 
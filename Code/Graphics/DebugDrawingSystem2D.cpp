@@ -22,6 +22,7 @@ void DebugDrawingSystem2D::OnAttachment( SystemManager* /*manager*/ )
 // 	m_debugMeshMaterial->SetModelMatrixUniform( "u_modelMatrix" );
 // 	m_debugMeshMaterial->SetViewMatrixUniform( "u_viewMatrix" );
 // 	m_debugMeshMaterial->SetProjectionMatrixUniform( "u_projectionMatrix" );
+// 	m_debugMeshMaterial->SetLineWidth( 5.f );
 // 
 // 	m_debugTextMaterial = RendererInterface::CreateOrGetNewMaterial( L"DebugTextMaterial" );
 // 	m_debugTextMaterial->SetShaderProgram( ShaderProgram::CreateOrGetShaderProgram( "Shaders/Basic.110.vertex.glsl", "Shaders/Basic.110.fragment.glsl" ) );
@@ -33,20 +34,16 @@ void DebugDrawingSystem2D::OnAttachment( SystemManager* /*manager*/ )
 //-----------------------------------------------------------------------------------------------
 void DebugDrawingSystem2D::OnEndFrame()
 {
-	for( unsigned int i = 0; i < m_meshes.size(); ++i )
-	{
-		if( m_meshes[ i ]->secondsLeftUntilDestroyed < 0.f )
-		{
-			CleanupTimedMesh( m_meshes[ i ] );
-			m_meshes.erase( m_meshes.begin() + i );
-		}
-	}
+	m_meshes.RemoveElementsWhere( TimedMeshHasExpired() );
 
 	//Clear "ownership" of components (the entity doesn't actually care about the components, the components just need an owner during creation)
-	m_debugMeshOwningEntity->attachedComponents.clear();
+	m_debugMeshOwningEntity->DetachAllComponents();
 }
 
 //-----------------------------------------------------------------------------------------------
+/* Consecutive meshes with the same material are copied into the batcher's pages and drawn
+	together. The batch is drawn whenever the material changes, or a mesh can't be batched, so
+	later debug draws still land on top of earlier ones. */
 void DebugDrawingSystem2D::OnRender() const
 {
 	RendererInterface::DisableFeature( RendererInterface::DEPTH_TESTING );
@@ -54,10 +51,25 @@ void DebugDrawingSystem2D::OnRender() const
 	RendererInterface::SetViewMatrixToIdentity();
 	RendererInterface::SetOrthographicProjection( m_leftXEdge, m_rightXEdge, m_bottomYEdge, m_topYEdge, 0.f, 1.f );
 
-	for( unsigned int i = 0; i < m_meshes.size(); ++i )
+	m_meshBatcher.BeginDynamicFrame();
+	const Material* batchedMaterial = nullptr;
+	for( unsigned int i = 0; i < m_meshes.GetNumberOfElements(); ++i )
 	{
-		RenderMeshComponent( m_meshes[ i ]->meshComponent );
+		const MeshComponent* mesh = m_meshes[ i ]->meshComponent;
+		if( mesh->material != batchedMaterial )
+		{
+			FlushBatchedMeshes();
+			batchedMaterial = mesh->material;
+		}
+
+		//Debug meshes are generated in screen coordinates, so they're batched untransformed
+		if( !m_meshBatcher.AddDynamicMesh( mesh->vertexData, mesh->material, F4X4_IDENTITY_MATRIX ) )
+		{
+			FlushBatchedMeshes();
+			RenderMeshComponent( mesh );
+		}
 	}
+	FlushBatchedMeshes();
 
 	RendererInterface::EnableDepthBufferWriting();
 	RendererInterface::EnableFeature( RendererInterface::DEPTH_TESTING );
@@ -66,7 +78,7 @@ void DebugDrawingSystem2D::OnRender() const
 //-----------------------------------------------------------------------------------------------
 void DebugDrawingSystem2D::OnUpdate( float deltaSeconds )
 {
-	for( unsigned int i = 0; i < m_meshes.size(); ++i )
+	for( unsigned int i = 0; i < m_meshes.GetNumberOfElements(); ++i )
 	{
 		m_meshes[ i ]->secondsLeftUntilDestroyed -= deltaSeconds;
 	}
@@ -75,31 +87,35 @@ void DebugDrawingSystem2D::OnUpdate( float deltaSeconds )
 //-----------------------------------------------------------------------------------------------
 void DebugDrawingSystem2D::OnDestruction()
 {
-	for( unsigned int i = 0; i < m_meshes.size(); ++i )
-	{
-		CleanupTimedMesh( m_meshes[ i ] );
-	}
-	m_meshes.clear();
+	m_meshes.ReleaseAllElements();
+	m_meshBatcher.Clear();
 	delete m_debugMeshOwningEntity;
 	//delete m_debugFont;
 }
 
 //-----------------------------------------------------------------------------------------------
-void DebugDrawingSystem2D::CleanupTimedMesh( TimedMesh* timedMesh )
+void DebugDrawingSystem2D::CleanupTimedMesh( TimedMesh*& timedMesh )
 {
 	timedMesh->meshComponent->material = nullptr; //Save our static material from destruction
 	delete timedMesh->meshComponent;
 	delete timedMesh;
+	timedMesh = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+void DebugDrawingSystem2D::FlushBatchedMeshes() const
+{
+	m_meshBatcher.Render();
+	m_meshBatcher.BeginDynamicFrame();
 }
 
 //-----------------------------------------------------------------------------------------------
 void DebugDrawingSystem2D::RenderMeshComponent( const MeshComponent* mesh ) const
 {
+	//The line width comes from the material, the same as it does for batched meshes
 	RendererInterface::ApplyMaterial( mesh->material );
 	//RendererInterface::BindVertexDataToShader( mesh->vertexData, mesh->material->pipeline );
 
-	RendererInterface::SetLineWidth( 5.f );
-
 	RendererInterface::RenderVertexArray( mesh->vertexData->shape, 0, mesh->vertexData->numberOfVertices );
 
 	//RendererInterface::UnbindVertexDataFromShader( mesh->vertexData, mesh->material->pipeline );
@@ -113,8 +129,8 @@ void DebugDrawingSystem2D::DrawPointForTime( const FloatVector2& centerPosition,
 	MeshComponent* newMesh = new MeshComponent();
 	newMesh->owner = m_debugMeshOwningEntity;
 	Generate2DPoint( *newMesh->vertexData, centerPosition, size, color );
-	m_meshes.push_back( new TimedMesh( lifetimeSeconds, newMesh ) );
-	m_meshes.back()->meshComponent->material = m_debugMeshMaterial;
+	newMesh->material = m_debugMeshMaterial;
+	m_meshes.AddElement( new TimedMesh( lifetimeSeconds, newMesh ) );
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -125,7 +141,7 @@ void DebugDrawingSystem2D::DrawTextForTime( const std::string& textString, const
 	newMesh->owner = m_debugMeshOwningEntity;
 	newMesh->vertexData = new VertexData();
 	GenerateTextMesh( *newMesh->vertexData, textString, position, color, m_debugFont, fontHeight );
-	m_meshes.push_back( new TimedMesh( lifetimeSeconds, newMesh ) );
-	m_meshes.back()->meshComponent->material = m_debugTextMaterial;
+	newMesh->material = m_debugTextMaterial;
+	m_meshes.AddElement( new TimedMesh( lifetimeSeconds, newMesh ) );
 }
 
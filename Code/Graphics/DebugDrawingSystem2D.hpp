@@ -8,7 +8,9 @@
 
 #include "../Math/FloatVector2.hpp"
 #include "../Color.hpp"
+#include "../DeferredRemovalVector.hpp"
 #include "../System.hpp"
+#include "MeshBatcher.hpp"
 
 struct BitmapFont;
 struct Entity;
@@ -31,6 +33,11 @@ class DebugDrawingSystem2D : public System
 		MeshComponent* meshComponent;
 	};
 
+	struct TimedMeshHasExpired
+	{
+		bool operator()( const TimedMesh* timedMesh ) const { return timedMesh->secondsLeftUntilDestroyed < 0.f; }
+	};
+
 public:
 	DebugDrawingSystem2D( float leftXEdge, float rightXEdge, float bottomYEdge, float topYEdge );
 	virtual ~DebugDrawingSystem2D() { }
@@ -49,13 +56,15 @@ public:
 	void OnUpdate( float deltaSeconds );
 	void OnDestruction();
 
-	void CleanupTimedMesh( TimedMesh* timedMesh );
+	void CleanupTimedMesh( TimedMesh*& timedMesh );
+	void FlushBatchedMeshes() const;
 	void RenderMeshComponent( const MeshComponent* mesh ) const;
 
 	//Data Members
 	//Clock m_clock;
 	Entity* m_debugMeshOwningEntity;
-	std::vector< TimedMesh* > m_meshes;
+	DeferredRemovalVector< TimedMesh > m_meshes;
+	mutable MeshBatcher m_meshBatcher;
 	BitmapFont* m_debugFont;
 	Material* m_debugMeshMaterial;
 	Material* m_debugTextMaterial;
@@ -73,6 +82,7 @@ inline DebugDrawingSystem2D::DebugDrawingSystem2D( float leftXEdge, float rightX
 												   float bottomYEdge, float topYEdge )
 	: System()
 	, m_debugMeshOwningEntity( nullptr )
+	, m_meshes( DeferredRemovalVector< TimedMesh >::REMOVAL_PRESERVES_ORDER ) //Later debug draws must stay on top
 	, m_debugFont( nullptr )
 	, m_debugMeshMaterial( nullptr )
 	, m_debugTextMaterial( nullptr )
@@ -81,7 +91,9 @@ inline DebugDrawingSystem2D::DebugDrawingSystem2D( float leftXEdge, float rightX
 	, m_bottomYEdge( bottomYEdge )
 	, m_topYEdge( topYEdge )
 {
-	m_meshes.reserve( 25 );
+	m_meshes.Reserve( 25 );
+	m_meshes.SetElementReleaser( DeferredRemovalVector< TimedMesh >::ElementReleaser::GenerateFromOneArgFunction<
+		DebugDrawingSystem2D, &DebugDrawingSystem2D::CleanupTimedMesh >( this ) );
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -128,6 +128,12 @@ GLSLShaderLoader::~GLSLShaderLoader()
 		delete m_pipelineCache[ i ];
 	}
 	m_pipelineCache.clear();
+
+	for( unsigned int i = 0; i < m_reflectedVariables.size(); ++i )
+	{
+		delete m_reflectedVariables[ i ];
+	}
+	m_reflectedVariables.clear();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -171,6 +177,7 @@ Shader* GLSLShaderLoader::CompileShaderOrDie( ShaderStage shaderType, const char
 	}
 
 	glUseProgram( 0 );
+	RendererInterface::ForgetCachedState();
 	GLuint newShaderID = glCreateShader( shaderType );
 
 	static const GLsizei NUMBER_OF_STRINGS_TO_LOAD = 1;
@@ -268,6 +275,7 @@ ShaderPipeline* GLSLShaderLoader::CreateOrGetPipelineFromShaders( const Shader*
 	DetachShaderFromPipeline( newPipeline->vertexShader, newPipeline );
 	DetachShaderFromPipeline( newPipeline->fragmentShader, newPipeline );
 
+	ReflectPipeline( newPipeline );
 	m_pipelineCache.push_back( newPipeline );
 	return newPipeline;
 }
@@ -276,6 +284,7 @@ ShaderPipeline* GLSLShaderLoader::CreateOrGetPipelineFromShaders( const Shader*
 void GLSLShaderLoader::DeletePipelineDataOnCard( ShaderPipeline* pipeline )
 {
 	glDeleteProgram( pipeline->programID );
+	RendererInterface::ForgetCachedState();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -320,6 +329,12 @@ ShaderVariable* GLSLShaderLoader::GetAttributeVariable( const ShaderPipeline* pi
 	return new ShaderVariable( glGetAttribLocation( pipeline->programID, attributeName ) );
 }
 
+//-----------------------------------------------------------------------------------------------
+int GLSLShaderLoader::GetAttributeVariableSlot( const ShaderVariable* variable ) const
+{
+	return variable->location;
+}
+
 //-----------------------------------------------------------------------------------------------
 int GLSLShaderLoader::GetNumberOfAttributesInPipeline( const ShaderPipeline* pipeline ) const
 {
@@ -458,4 +473,51 @@ void GLSLShaderLoader::GetInfoLogForShader( char*& out_infoLog, int& out_infoLog
 	glGetShaderInfoLog( shaderID, out_infoLogSize, DO_NOT_WANT_NUMBER_CHARS_RETURNED, out_infoLog );
 }
 
+//-----------------------------------------------------------------------------------------------
+/* Arrays are reported once, as their first element, so the other elements are looked up here
+	too; that way "u_boneTransformationMatrices[5]" has a slot like any other uniform. */
+void GLSLShaderLoader::ReflectPipeline( ShaderPipeline* pipeline )
+{
+	static const GLsizei MAX_VARIABLE_NAME_LENGTH = 256;
+	static GLsizei* DO_NOT_WANT_NAME_LENGTH_RETURNED = nullptr;
+	GLchar variableName[ MAX_VARIABLE_NAME_LENGTH ];
+	GLint numberOfArrayElements = 0;
+	GLenum variableType = 0;
+
+	int numberOfUniforms = GetNumberOfUniformsInPipeline( pipeline );
+	for( int i = 0; i < numberOfUniforms; ++i )
+	{
+		glGetActiveUniform( pipeline->programID, i, MAX_VARIABLE_NAME_LENGTH, DO_NOT_WANT_NAME_LENGTH_RETURNED, &numberOfArrayElements, &variableType, variableName );
+
+		ShaderVariable* uniform = new ShaderVariable( glGetUniformLocation( pipeline->programID, variableName ) );
+		m_reflectedVariables.push_back( uniform );
+		pipeline->reflection.AddUniform( variableName, uniform );
+
+		char* firstElementSuffix = strstr( variableName, "[0]" );
+		if( numberOfArrayElements <= 1 || firstElementSuffix == nullptr )
+			continue;
+
+		std::string arrayName( variableName, firstElementSuffix - variableName );
+		for( int element = 1; element < numberOfArrayElements; ++element )
+		{
+			std::string elementName( arrayName + "[" + ConvertIntegerToString( element ) + "]" );
+			ShaderVariable* elementUniform = new ShaderVariable( glGetUniformLocation( pipeline->programID, elementName.c_str() ) );
+			m_reflectedVariables.push_back( elementUniform );
+			pipeline->reflection.AddUniform( elementName.c_str(), elementUniform );
+		}
+	}
+
+	int numberOfAttributes = GetNumberOfAttributesInPipeline( pipeline );
+	for( int i = 0; i < numberOfAttributes; ++i )
+	{
+		glGetActiveAttrib( pipeline->programID, i, MAX_VARIABLE_NAME_LENGTH, DO_NOT_WANT_NAME_LENGTH_RETURNED, &numberOfArrayElements, &variableType, variableName );
+
+		ShaderVariable* attribute = new ShaderVariable( glGetAttribLocation( pipeline->programID, variableName ) );
+		m_reflectedVariables.push_back( attribute );
+		pipeline->reflection.AddAttribute( variableName, attribute );
+	}
+
+	pipeline->reflection.FinishBuilding();
+}
+
 #endif //defined( SHADER_LOADER_USING_GLSL )
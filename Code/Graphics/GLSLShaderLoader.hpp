@@ -54,6 +54,7 @@ struct ShaderPipeline
 	const Shader* geometryShader;
 	const Shader* fragmentShader;
 	int programID;
+	ShaderReflection reflection;
 };
 
 
@@ -84,9 +85,11 @@ public:
 	void DisableAttributeVariableInShader( const ShaderVariable* variable );
 	void EnableAttributeVariableInShader( const ShaderVariable* variable );
 	ShaderVariable* GetAttributeVariable( const ShaderPipeline* pipeline, const char* attributeName );
+	int GetAttributeVariableSlot( const ShaderVariable* variable ) const;
 	int GetNumberOfAttributesInPipeline( const ShaderPipeline* pipeline ) const;
 	int GetNumberOfUniformsInPipeline( const ShaderPipeline* pipeline ) const;
 	ShaderVariable* GetUniformVariable( const ShaderPipeline* pipeline, const char* uniformName );
+	const ShaderReflection& GetPipelineReflection( const ShaderPipeline* pipeline ) const { return pipeline->reflection; }
 	void LoadSourceFromFileOrDie( char*& out_shaderData, const char* fileName );
 	void SetTextureUnitUniform( ShaderVariable* variable, unsigned int samplerUnitNumber );
 	void SetUniform( ShaderVariable* variable, int integer );
@@ -104,9 +107,11 @@ private:
 	//Helpers
 	void GetInfoLogForProgram( char*& out_infoLog, int& out_infoLogSize, int programID );
 	void GetInfoLogForShader( char*& out_infoLog, int& out_infoLogSize, int shaderID );
+	void ReflectPipeline( ShaderPipeline* pipeline );
 
 	//Data Members
 	std::vector< ShaderPipeline* > m_pipelineCache;
+	std::vector< ShaderVariable* > m_reflectedVariables;
 	std::map< std::string, Shader > m_shaderCache;
 };
 
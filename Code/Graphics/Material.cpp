@@ -9,26 +9,28 @@ void Material::BindMatrixToShader( MatrixReturningFunction matrixUpdater, const
 {
 	FATAL_ASSERTION( pipeline != nullptr, "Material Error", "Cannot bind shader variables to a material without a shader pipeline." );
 
-	CachingShaderLoader* shaderLoader = RendererInterface::GetShaderLoader();
-	ShaderVariable* shaderVariable = shaderLoader->GetUniformVariable( pipeline, shaderVariableName );
+	const ShaderReflection& reflection = RendererInterface::GetShaderLoader()->GetPipelineReflection( pipeline );
+	ShaderVariable* shaderVariable = reflection.GetUniform( reflection.FindUniformSlot( HashStringLiteral( shaderVariableName ) ) );
 
 	matrixBindings.push_back( ShaderBinding< Float4x4Matrix >( shaderVariable, matrixUpdater ) );
 }
 
 //-----------------------------------------------------------------------------------------------
-int Material::GetValidAttributeIDFromNameOrDie( const std::string& /*attributeName*/ ) const
+ShaderReflection::Slot Material::GetValidAttributeIDFromNameOrDie( const std::string& attributeName ) const
 {
-	int attributeID = 0;//RendererInterface::GetAttributeLocation( program, attributeName );
-	assert( attributeID != -1 );
-	return attributeID;
+	const ShaderReflection& reflection = RendererInterface::GetShaderLoader()->GetPipelineReflection( pipeline );
+	ShaderReflection::Slot attributeSlot = reflection.FindAttributeSlot( HashStringLiteral( attributeName.c_str() ) );
+	assert( attributeSlot != ShaderReflection::SLOT_None );
+	return attributeSlot;
 }
 
 //-----------------------------------------------------------------------------------------------
-int Material::GetValidUniformIDFromNameOrDie( const std::string& /*uniformName*/ ) const
+ShaderReflection::Slot Material::GetValidUniformIDFromNameOrDie( const std::string& uniformName ) const
 {
-	int uniformID = 0;//RendererInterface::GetUniformVariableLocation( program, uniformName );
-	assert( uniformID != -1 );
-	return uniformID;
+	const ShaderReflection& reflection = RendererInterface::GetShaderLoader()->GetPipelineReflection( pipeline );
+	ShaderReflection::Slot uniformSlot = reflection.FindUniformSlot( HashStringLiteral( uniformName.c_str() ) );
+	assert( uniformSlot != ShaderReflection::SLOT_None );
+	return uniformSlot;
 }
 
 //-----------------------------------------------------------------------------------------------
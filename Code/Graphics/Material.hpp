@@ -41,15 +41,21 @@ struct Material
 	static const TextureType TEXTURE_SpecularMap = 2;
 	static const TextureType TEXTURE_EmissiveMap = 3;
 
+	//Passes are drawn in this order; translucent materials are drawn back to front
+	typedef unsigned char RenderPass;
+	static const RenderPass PASS_Opaque			= 0;
+	static const RenderPass PASS_Translucent	= 1;
+	static const RenderPass PASS_Overlay		= 2;
+
 	struct TextureInfo
 	{
 		TextureInfo()
 			: textureUnitID( 0 )
-			, samplerUniformVariable( nullptr )
+			, samplerUniformSlot( ShaderReflection::SLOT_None )
 			, texture( nullptr )
 		{ }
 		int textureUnitID;
-		ShaderVariable* samplerUniformVariable;
+		ShaderReflection::Slot samplerUniformSlot;
 		const Texture* texture;
 	};
 
@@ -57,8 +63,8 @@ struct Material
 	Material();
 	~Material();
 
-	int GetValidAttributeIDFromNameOrDie( const std::string& attributeName ) const;
-	int GetValidUniformIDFromNameOrDie( const std::string& uniformName ) const;
+	ShaderReflection::Slot GetValidAttributeIDFromNameOrDie( const std::string& attributeName ) const;
+	ShaderReflection::Slot GetValidUniformIDFromNameOrDie( const std::string& uniformName ) const;
 
 	void SetFloatUniform( const std::string& uniformName, float value );
 	void SetFloatUniform( const std::string& uniformName, const FloatVector3& vector );
@@ -70,7 +76,8 @@ struct Material
 	void SetViewMatrixUniform( const std::string& uniformName );
 	void SetProjectionMatrixUniform( const std::string& uniformName );
 	void SetLineWidth( float newLineWidth ) { lineWidth = newLineWidth; }
-	void SetShaderPipeline( const ShaderPipeline* shaderPipeline ) { pipeline = shaderPipeline; }
+	void SetRenderPass( RenderPass pass ) { renderPass = pass; }
+	void SetShaderPipeline( const ShaderPipeline* shaderPipeline );
 	void SetTextureUniform( const std::string& uniformName, int textureUnitID, const Texture* texture );
 	void SetTextureUniform( const std::string& uniformName, int textureUnitID, const std::string& textureFileLocation, 
 							Texture::FilteringMethod filteringMethod, Texture::WrappingMode wrappingMode );
@@ -78,11 +85,12 @@ struct Material
 
 	//Data Members
 	const ShaderPipeline* pipeline;
-	int modelMatrixUniformLocation;
-	int viewMatrixUniformLocation;
-	int projectionMatrixUniformLocation;
+	ShaderReflection::Slot modelMatrixUniformSlot; //SLOT_None uses the pipeline's standard u_modelMatrix
+	ShaderReflection::Slot viewMatrixUniformSlot;
+	ShaderReflection::Slot projectionMatrixUniformSlot;
 	std::vector< TextureInfo > infoForTextures;
 	float lineWidth;
+	RenderPass renderPass;
 	std::vector< ShaderBinding<Float4x4Matrix> > matrixBindings;
 };
 
@@ -91,10 +99,11 @@ struct Material
 //-----------------------------------------------------------------------------------------------
 inline Material::Material()
 	: pipeline( nullptr )
-	, modelMatrixUniformLocation( -1 )
-	, viewMatrixUniformLocation( -1 )
-	, projectionMatrixUniformLocation( -1 )
+	, modelMatrixUniformSlot( ShaderReflection::SLOT_None )
+	, viewMatrixUniformSlot( ShaderReflection::SLOT_None )
+	, projectionMatrixUniformSlot( ShaderReflection::SLOT_None )
 	, lineWidth( 1 )
+	, renderPass( PASS_Opaque )
 { }
 
 inline Material::~Material()
@@ -103,36 +112,45 @@ inline Material::~Material()
 //-----------------------------------------------------------------------------------------------
 inline void Material::SetModelMatrixUniform( const std::string& uniformName )
 {
-	int uniformID = GetValidUniformIDFromNameOrDie( uniformName );
-
-	modelMatrixUniformLocation = uniformID;
+	modelMatrixUniformSlot = GetValidUniformIDFromNameOrDie( uniformName );
 }
 
 //-----------------------------------------------------------------------------------------------
 inline void Material::SetViewMatrixUniform( const std::string& uniformName )
 {
-	int uniformID = GetValidUniformIDFromNameOrDie( uniformName );
-
-	viewMatrixUniformLocation = uniformID;
+	viewMatrixUniformSlot = GetValidUniformIDFromNameOrDie( uniformName );
 }
 
 //-----------------------------------------------------------------------------------------------
 inline void Material::SetProjectionMatrixUniform( const std::string& uniformName )
 {
-	int uniformID = GetValidUniformIDFromNameOrDie( uniformName );
+	projectionMatrixUniformSlot = GetValidUniformIDFromNameOrDie( uniformName );
+}
 
-	projectionMatrixUniformLocation = uniformID;
+//-----------------------------------------------------------------------------------------------
+/* Slots index the pipeline's own reflection, so overrides and texture samplers from an earlier
+	pipeline are dropped. Textures should be set after the pipeline, since their samplers are
+	looked up in it. */
+inline void Material::SetShaderPipeline( const ShaderPipeline* shaderPipeline )
+{
+	pipeline = shaderPipeline;
+	modelMatrixUniformSlot = ShaderReflection::SLOT_None;
+	viewMatrixUniformSlot = ShaderReflection::SLOT_None;
+	projectionMatrixUniformSlot = ShaderReflection::SLOT_None;
+	for( unsigned int i = 0; i < infoForTextures.size(); ++i )
+		infoForTextures[ i ].samplerUniformSlot = ShaderReflection::SLOT_None;
 }
 
 //-----------------------------------------------------------------------------------------------
 inline void Material::SetTextureUniform( const std::string& uniformName, int textureUnitID, const Texture* texture )
 {
+	const ShaderReflection& reflection = RendererInterface::GetShaderLoader()->GetPipelineReflection( pipeline );
+
 	TextureInfo texInfo;
 	texInfo.textureUnitID = textureUnitID;
 	texInfo.texture = texture;
-	texInfo.samplerUniformVariable = RendererInterface::GetShaderLoader()->GetUniformVariable( pipeline, uniformName.c_str() );
+	texInfo.samplerUniformSlot = reflection.FindUniformSlot( HashStringLiteral( uniformName.c_str() ) );
 	infoForTextures.push_back( texInfo );
-	// FIX: We are leaking the memory for this uniform variable.
 }
 
 #endif //INCLUDED_MATERIAL_HPP
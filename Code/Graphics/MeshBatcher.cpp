@@ -0,0 +1,299 @@
+#include "MeshBatcher.hpp"
+
+#include <math.h>
+#include <string.h>
+
+#include "../EngineMacros.hpp"
+#include "Material.hpp"
+#include "RendererInterface.hpp"
+#include "VertexAttribute.hpp"
+#include "VertexData.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+static bool IsListShape( RendererInterface::Shape shape )
+{
+	return ( shape == RendererInterface::TRIANGLES ) || ( shape == RendererInterface::LINES ) || ( shape == RendererInterface::POINTS );
+}
+
+//-----------------------------------------------------------------------------------------------
+static bool IsDirectionAttribute( const VertexAttribute& attribute )
+{
+	static const HashedString::Hash NORMAL_NAME_HASH = HashStringLiteral( RendererInterface::DEFAULT_NAME_Normal );
+	static const HashedString::Hash TANGENT_NAME_HASH = HashStringLiteral( RendererInterface::DEFAULT_NAME_Tangent );
+	static const HashedString::Hash BITANGENT_NAME_HASH = HashStringLiteral( RendererInterface::DEFAULT_NAME_Bitangent );
+
+	if( attribute.coordinateType != RendererInterface::TYPE_FLOAT || attribute.numberOfComponents != 3 )
+		return false;
+
+	return ( attribute.shaderVariableNameHash == NORMAL_NAME_HASH ) || ( attribute.shaderVariableNameHash == TANGENT_NAME_HASH ) ||
+			( attribute.shaderVariableNameHash == BITANGENT_NAME_HASH );
+}
+
+//-----------------------------------------------------------------------------------------------
+static bool IsPositionAttribute( const VertexAttribute& attribute )
+{
+	static const HashedString::Hash POSITION_NAME_HASH = HashStringLiteral( RendererInterface::DEFAULT_NAME_Vertex );
+
+	return ( attribute.shaderVariableNameHash == POSITION_NAME_HASH ) && ( attribute.coordinateType == RendererInterface::TYPE_FLOAT ) &&
+			( attribute.numberOfComponents == 2 || attribute.numberOfComponents == 3 );
+}
+
+//-----------------------------------------------------------------------------------------------
+static bool HaveSameLayout( const VertexData& first, const VertexData& second )
+{
+	if( first.vertexSizeBytes != second.vertexSizeBytes || first.shape != second.shape || first.attributes.size() != second.attributes.size() )
+		return false;
+
+	for( unsigned int i = 0; i < first.attributes.size(); ++i )
+	{
+		const VertexAttribute& firstAttribute = first.attributes[ i ];
+		const VertexAttribute& secondAttribute = second.attributes[ i ];
+		if( firstAttribute.shaderVariableNameHash != secondAttribute.shaderVariableNameHash ||
+			firstAttribute.numberOfComponents != secondAttribute.numberOfComponents ||
+			firstAttribute.coordinateType != secondAttribute.coordinateType ||
+			firstAttribute.normalizeFixedPointData != secondAttribute.normalizeFixedPointData ||
+			firstAttribute.attributeOffsetInStructure != secondAttribute.attributeOffsetInStructure )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Matrices here multiply row vectors, so the translation is in elements 12 to 14. */
+static void TransformVerticesToWorld( char* vertices, unsigned int numberOfVertices, const VertexData& layout, const Float4x4Matrix& modelMatrix )
+{
+	const float* m = modelMatrix.GetRawBuffer();
+
+	for( unsigned int a = 0; a < layout.attributes.size(); ++a )
+	{
+		const VertexAttribute& attribute = layout.attributes[ a ];
+		bool isPosition = IsPositionAttribute( attribute );
+		if( !isPosition && !IsDirectionAttribute( attribute ) )
+			continue;
+
+		char* attributeData = vertices + attribute.attributeOffsetInStructure;
+		for( unsigned int i = 0; i < numberOfVertices; ++i, attributeData += layout.vertexSizeBytes )
+		{
+			float* vector = reinterpret_cast< float* >( attributeData );
+			float x = vector[ 0 ];
+			float y = vector[ 1 ];
+			float z = ( attribute.numberOfComponents == 3 ) ? vector[ 2 ] : 0.f;
+
+			if( isPosition )
+			{
+				vector[ 0 ] = x * m[ 0 ] + y * m[ 4 ] + z * m[ 8 ] + m[ 12 ];
+				vector[ 1 ] = x * m[ 1 ] + y * m[ 5 ] + z * m[ 9 ] + m[ 13 ];
+				if( attribute.numberOfComponents == 3 )
+					vector[ 2 ] = x * m[ 2 ] + y * m[ 6 ] + z * m[ 10 ] + m[ 14 ];
+				continue;
+			}
+
+			float rotatedX = x * m[ 0 ] + y * m[ 4 ] + z * m[ 8 ];
+			float rotatedY = x * m[ 1 ] + y * m[ 5 ] + z * m[ 9 ];
+			float rotatedZ = x * m[ 2 ] + y * m[ 6 ] + z * m[ 10 ];
+			float lengthSquared = rotatedX * rotatedX + rotatedY * rotatedY + rotatedZ * rotatedZ;
+			float inverseLength = ( lengthSquared > 0.f ) ? 1.f / sqrt( lengthSquared ) : 0.f;
+			vector[ 0 ] = rotatedX * inverseLength;
+			vector[ 1 ] = rotatedY * inverseLength;
+			vector[ 2 ] = rotatedZ * inverseLength;
+		}
+	}
+}
+
+
+
+//-----------------------------------------------------------------------------------------------
+MeshBatcher::~MeshBatcher()
+{
+	Clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Attributes must be interleaved in one array, since vertices are copied whole. */
+STATIC bool MeshBatcher::CanBatch( const VertexData* vertData )
+{
+	if( vertData->data == nullptr || vertData->numberOfVertices == 0 || !IsListShape( vertData->shape ) )
+		return false;
+
+	bool hasPosition = false;
+	for( unsigned int i = 0; i < vertData->attributes.size(); ++i )
+	{
+		const VertexAttribute& attribute = vertData->attributes[ i ];
+		if( attribute.bytesUntilNextInstance != vertData->vertexSizeBytes )
+			return false;
+		hasPosition = hasPosition || IsPositionAttribute( attribute );
+	}
+	return hasPosition;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool MeshBatcher::AddStaticMesh( const VertexData* vertData, const Material* material, const Float4x4Matrix& modelMatrix )
+{
+	return AddMesh( vertData, material, modelMatrix, false );
+}
+
+//-----------------------------------------------------------------------------------------------
+bool MeshBatcher::AddDynamicMesh( const VertexData* vertData, const Material* material, const Float4x4Matrix& modelMatrix )
+{
+	return AddMesh( vertData, material, modelMatrix, true );
+}
+
+//-----------------------------------------------------------------------------------------------
+//Empties the dynamic batches but keeps their pages and buffers for this frame's meshes
+void MeshBatcher::BeginDynamicFrame()
+{
+	for( unsigned int i = 0; i < m_batches.size(); ++i )
+	{
+		Batch& batch = m_batches[ i ];
+		if( !batch.isDynamic )
+			continue;
+
+		batch.numberOfMeshes = 0;
+		batch.fillPageIndex = 0;
+		for( unsigned int p = 0; p < batch.pages.size(); ++p )
+		{
+			batch.pages[ p ].vertices->numberOfVertices = 0;
+			batch.pages[ p ].needsUpload = true;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void MeshBatcher::Clear()
+{
+	for( unsigned int i = 0; i < m_batches.size(); ++i )
+	{
+		Batch& batch = m_batches[ i ];
+		for( unsigned int p = 0; p < batch.pages.size(); ++p )
+			delete batch.pages[ p ].vertices;
+	}
+	m_batches.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+void MeshBatcher::Render()
+{
+	MeshBatcherStatistics statistics;
+	const Material* lastMaterial = nullptr;
+
+	//Vertices are already in world space
+	RendererInterface::PushMatrix();
+	RendererInterface::SetTopOfStackToIdentity();
+
+	for( unsigned int i = 0; i < m_batches.size(); ++i )
+	{
+		Batch& batch = m_batches[ i ];
+		if( batch.numberOfMeshes == 0 )
+			continue;
+
+		RendererInterface::ApplyMaterial( batch.material );
+		lastMaterial = batch.material;
+		statistics.numberOfMeshes += batch.numberOfMeshes;
+
+		for( unsigned int p = 0; p < batch.pages.size(); ++p )
+		{
+			Page& page = batch.pages[ p ];
+			if( page.vertices->numberOfVertices == 0 )
+				continue;
+
+			if( page.needsUpload )
+			{
+				RendererInterface::BufferVertexData( page.vertices );
+				statistics.bytesUploaded += page.vertices->numberOfVertices * page.vertices->vertexSizeBytes;
+				page.needsUpload = false;
+			}
+
+			RendererInterface::BindVertexDataToShader( page.vertices, batch.material->pipeline );
+			RendererInterface::RenderVertexArray( page.vertices->shape, 0, page.vertices->numberOfVertices );
+			RendererInterface::UnbindVertexDataFromShader( page.vertices, batch.material->pipeline );
+			++statistics.numberOfDraws;
+		}
+	}
+
+	if( lastMaterial != nullptr )
+		RendererInterface::RemoveMaterial( lastMaterial );
+	RendererInterface::PopMatrix();
+
+	m_lastRenderStatistics = statistics;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool MeshBatcher::AddMesh( const VertexData* vertData, const Material* material, const Float4x4Matrix& modelMatrix, bool isDynamic )
+{
+	if( !CanBatch( vertData ) )
+		return false;
+
+	Batch& batch = FindOrCreateBatch( vertData, material, isDynamic );
+	Page& page = FindOrCreatePageWithRoom( batch, vertData );
+
+	char* firstNewVertex = static_cast< char* >( page.vertices->data ) + page.vertices->numberOfVertices * page.vertices->vertexSizeBytes;
+	memcpy( firstNewVertex, vertData->data, vertData->numberOfVertices * vertData->vertexSizeBytes );
+	TransformVerticesToWorld( firstNewVertex, vertData->numberOfVertices, *vertData, modelMatrix );
+
+	page.vertices->numberOfVertices += vertData->numberOfVertices;
+	page.needsUpload = true;
+	++batch.numberOfMeshes;
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+MeshBatcher::Batch& MeshBatcher::FindOrCreateBatch( const VertexData* vertData, const Material* material, bool isDynamic )
+{
+	for( unsigned int i = 0; i < m_batches.size(); ++i )
+	{
+		Batch& batch = m_batches[ i ];
+		if( batch.material == material && batch.isDynamic == isDynamic && HaveSameLayout( *batch.pages[ 0 ].vertices, *vertData ) )
+			return batch;
+	}
+
+	m_batches.push_back( Batch() );
+	Batch& newBatch = m_batches.back();
+	newBatch.material = material;
+	newBatch.isDynamic = isDynamic;
+	newBatch.numberOfMeshes = 0;
+	newBatch.fillPageIndex = 0;
+	FindOrCreatePageWithRoom( newBatch, vertData );
+	return newBatch;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Pages are searched in order from the batch's fill page, so a dynamic batch refills the pages it
+	kept from earlier frames before it makes any new ones. A mesh too big for a page's remaining
+	room skips it without giving up on it; the fill page only moves past pages that are completely
+	full, so smaller meshes can still top up the ones that were skipped. */
+MeshBatcher::Page& MeshBatcher::FindOrCreatePageWithRoom( Batch& batch, const VertexData* vertData )
+{
+	while( batch.fillPageIndex < batch.pages.size() )
+	{
+		const Page& fillPage = batch.pages[ batch.fillPageIndex ];
+		if( fillPage.vertices->numberOfVertices < fillPage.capacityVertices )
+			break;
+		++batch.fillPageIndex;
+	}
+
+	for( unsigned int i = batch.fillPageIndex; i < batch.pages.size(); ++i )
+	{
+		Page& page = batch.pages[ i ];
+		if( page.vertices->numberOfVertices + vertData->numberOfVertices <= page.capacityVertices )
+			return page;
+	}
+
+	unsigned int capacityVertices = PAGE_SIZE_BYTES / vertData->vertexSizeBytes;
+	if( capacityVertices < vertData->numberOfVertices )
+		capacityVertices = vertData->numberOfVertices;
+
+	Page newPage;
+	newPage.vertices = new VertexData( capacityVertices, vertData->vertexSizeBytes );
+	newPage.vertices->numberOfVertices = 0;
+	newPage.vertices->attributes = vertData->attributes;
+	newPage.vertices->shape = vertData->shape;
+	RendererInterface::GenerateBuffer( 1, &newPage.vertices->bufferID );
+	newPage.capacityVertices = capacityVertices;
+	newPage.needsUpload = true;
+
+	batch.pages.push_back( newPage );
+	return batch.pages.back();
+}
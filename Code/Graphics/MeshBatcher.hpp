@@ -0,0 +1,96 @@
+#pragma once
+#ifndef INCLUDED_MESH_BATCHER_HPP
+#define INCLUDED_MESH_BATCHER_HPP
+
+//-----------------------------------------------------------------------------------------------
+#include <vector>
+
+#include "../Math/Float4x4Matrix.hpp"
+
+struct Material;
+struct VertexData;
+
+
+//-----------------------------------------------------------------------------------------------
+struct MeshBatcherStatistics
+{
+	MeshBatcherStatistics()
+		: numberOfMeshes( 0 )
+		, numberOfDraws( 0 )
+		, bytesUploaded( 0 )
+	{ }
+
+	//Data Members
+	unsigned int numberOfMeshes;
+	unsigned int numberOfDraws;
+	unsigned int bytesUploaded;
+};
+
+
+
+//-----------------------------------------------------------------------------------------------
+/* Copies many small meshes into a few large vertex buffers, so meshes that share a material and a
+	vertex layout are drawn with one call per page instead of one call each.
+
+	Vertices are transformed into world space as they're copied, so each batch is drawn with an
+	identity model matrix. Positions must be 2 or 3 floats named DEFAULT_NAME_Vertex; normals,
+	tangents and bitangents are rotated too, which assumes the matrices don't scale unevenly.
+	Only list shapes (triangles, lines and points) can be joined end to end.
+
+	Static meshes are copied once and their pages are only uploaded again when more are added.
+	Dynamic meshes are copied every frame between BeginDynamicFrame and Render, reusing the same
+	pages and buffers from frame to frame. */
+class MeshBatcher
+{
+public:
+	static const unsigned int PAGE_SIZE_BYTES = 1024 * 1024; //Larger meshes get a page of their own
+
+	MeshBatcher() { }
+	~MeshBatcher();
+
+	static bool CanBatch( const VertexData* vertData );
+
+	//Return false if the mesh can't be batched and should be drawn on its own
+	bool AddStaticMesh( const VertexData* vertData, const Material* material, const Float4x4Matrix& modelMatrix );
+	bool AddDynamicMesh( const VertexData* vertData, const Material* material, const Float4x4Matrix& modelMatrix );
+
+	void BeginDynamicFrame();
+	void Clear();
+	void Render(); //Uploads any pages that changed before drawing them
+
+	const MeshBatcherStatistics& GetLastRenderStatistics() const { return m_lastRenderStatistics; }
+
+
+private:
+	//-------------------------------------------------------------------------------------------
+	struct Page
+	{
+		VertexData* vertices; //Buffered; numberOfVertices counts the ones in use
+		unsigned int capacityVertices;
+		bool needsUpload;
+	};
+
+	//-------------------------------------------------------------------------------------------
+	struct Batch
+	{
+		const Material* material;
+		bool isDynamic;
+		unsigned int numberOfMeshes;
+		unsigned int fillPageIndex; //Pages before this one are full; reset by BeginDynamicFrame
+		std::vector< Page > pages;
+	};
+
+	//Copy and assign are not allowed
+	MeshBatcher( const MeshBatcher& );
+	void operator=( const MeshBatcher& );
+
+	bool AddMesh( const VertexData* vertData, const Material* material, const Float4x4Matrix& modelMatrix, bool isDynamic );
+	Batch& FindOrCreateBatch( const VertexData* vertData, const Material* material, bool isDynamic );
+	Page& FindOrCreatePageWithRoom( Batch& batch, const VertexData* vertData );
+
+	//Data Members
+	std::vector< Batch > m_batches;
+	MeshBatcherStatistics m_lastRenderStatistics;
+};
+
+#endif //INCLUDED_MESH_BATCHER_HPP
@@ -69,6 +69,9 @@ public:
 	//Vertex Arrays
 	void DoRenderPartOfArray( Shape drawingShape, unsigned int numberPointsToDraw, CoordinateType indexType, const void* firstIndexToRender ) const;
 	void DoRenderVertexArray( Shape drawingShape, unsigned int startingArrayIndex, unsigned int numberPointsInArray ) const;
+	void DoRenderVertexArrayInstanced( Shape drawingShape, unsigned int startingArrayIndex, unsigned int numberPointsInArray, unsigned int numberOfInstances ) const;
+	void DoSetGenericArrayInstanceDivisor( unsigned int variableLocation, unsigned int instancesPerElement ) const;
+	bool DoSupportsInstancing() const { return false; }
 	void DoSetPointerToColorArray( unsigned int coordinatesPerVertex, CoordinateType coordinateType, unsigned int gapBetweenVertices, const void* firstVertexInArray ) const;
 	void DoSetPointerToGenericArray( unsigned int variableLocation, int numberOfVertexCoordinates, CoordinateType coordinateType, bool normalizeData, unsigned int gapBetweenVertices, const void* firstVertexInArray ) const;
 	void DoSetPointerToTextureCoordinateArray( unsigned int coordinatesPerVertex, CoordinateType coordinateType, unsigned int gapBetweenVertices, const void* firstVertexInArray ) const;
@@ -298,6 +301,16 @@ inline void NullRendererInterface::DoRenderVertexArray( Shape /*drawingShape*/,
 {
 }
 
+//-----------------------------------------------------------------------------------------------
+inline void NullRendererInterface::DoRenderVertexArrayInstanced( Shape /*drawingShape*/, unsigned int /*startingArrayIndex*/, unsigned int /*numberPointsInArray*/, unsigned int /*numberOfInstances*/ ) const
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+inline void NullRendererInterface::DoSetGenericArrayInstanceDivisor( unsigned int /*variableLocation*/, unsigned int /*instancesPerElement*/ ) const
+{
+}
+
 //-----------------------------------------------------------------------------------------------
 inline void NullRendererInterface::DoSetPointerToColorArray( unsigned int /*coordinatesPerVertex*/, CoordinateType /*coordinateType*/, unsigned int /*gapBetweenVertices*/, const void* /*firstVertexInArray*/ ) const
 {
@@ -49,9 +49,11 @@ public:
 	void DisableAttributeVariableInShader( const ShaderVariable* variable ) { }
 	void EnableAttributeVariableInShader( const ShaderVariable* variable ) { }
 	ShaderVariable* GetAttributeVariable( const ShaderPipeline* pipeline, const char* attributeName ) { return nullptr; }
+	int GetAttributeVariableSlot( const ShaderVariable* variable ) const { return -1; }
 	int GetNumberOfAttributesInPipeline( const ShaderPipeline* pipeline ) const { return 0; }
 	int GetNumberOfUniformsInPipeline( const ShaderPipeline* pipeline ) const { return 0; }
 	ShaderVariable* GetUniformVariable( const ShaderPipeline* pipeline, const char* uniformName ) { return nullptr; }
+	const ShaderReflection& GetPipelineReflection( const ShaderPipeline* pipeline ) const { static const ShaderReflection NO_VARIABLES; return NO_VARIABLES; }
 	void LoadSourceFromFileOrDie( char*& out_shaderData, const char* fileName ) { }
 	void SetTextureUnitUniform( ShaderVariable* variable, unsigned int samplerUnitNumber ) { }
 	void SetUniform( ShaderVariable* variable, int integer ) { }
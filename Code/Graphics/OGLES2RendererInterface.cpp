@@ -4,6 +4,9 @@
 
 #include "OGLES2RendererInterface.hpp"
 
+#include <EGL/egl.h>
+#include <string.h>
+
 #pragma region Renderer_to_OpenGL_Constant_Definitions
 //-----------------------------------------------------------------------------------------------
 STATIC const RendererInterface::ArrayType RendererInterface::COLOR_ARRAYS			= GL_FALSE;
@@ -70,4 +73,28 @@ STATIC const RendererInterface::TextureWrapMode RendererInterface::REPEAT_OVER_G
 STATIC const RendererInterface::TextureWrapMode RendererInterface::REPEAT_FLIPPED = GL_MIRRORED_REPEAT;
 #pragma endregion
 
+//-----------------------------------------------------------------------------------------------
+/* eglGetProcAddress may hand back a stub for functions the context doesn't support, so each
+	source is only tried when the version or extension string says it's there. */
+void OGLES2RendererInterface::Initialize()
+{
+	const char* versionString = reinterpret_cast< const char* >( glGetString( GL_VERSION ) );
+	const char* extensionsString = reinterpret_cast< const char* >( glGetString( GL_EXTENSIONS ) );
+
+	if( versionString != nullptr && strncmp( versionString, "OpenGL ES 3", 11 ) == 0 )
+	{
+		m_drawArraysInstanced = ( PFNGLDRAWARRAYSINSTANCEDEXTPROC ) eglGetProcAddress( "glDrawArraysInstanced" );
+		m_vertexAttribDivisor = ( PFNGLVERTEXATTRIBDIVISOREXTPROC ) eglGetProcAddress( "glVertexAttribDivisor" );
+	}
+	else if( extensionsString != nullptr && strstr( extensionsString, "GL_EXT_instanced_arrays" ) != nullptr )
+	{
+		m_drawArraysInstanced = ( PFNGLDRAWARRAYSINSTANCEDEXTPROC ) eglGetProcAddress( "glDrawArraysInstancedEXT" );
+		m_vertexAttribDivisor = ( PFNGLVERTEXATTRIBDIVISOREXTPROC ) eglGetProcAddress( "glVertexAttribDivisorEXT" );
+	}
+	else if( extensionsString != nullptr && strstr( extensionsString, "GL_ANGLE_instanced_arrays" ) != nullptr )
+	{
+		m_drawArraysInstanced = ( PFNGLDRAWARRAYSINSTANCEDEXTPROC ) eglGetProcAddress( "glDrawArraysInstancedANGLE" );
+		m_vertexAttribDivisor = ( PFNGLVERTEXATTRIBDIVISOREXTPROC ) eglGetProcAddress( "glVertexAttribDivisorANGLE" );
+	}
+}
 #endif //defined( RENDERER_INTERFACE_USE_OPENGL_ES2 )
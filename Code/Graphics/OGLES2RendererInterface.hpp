@@ -73,6 +73,9 @@ public:
 	//Vertex Arrays
 	void DoRenderPartOfArray( Shape drawingShape, unsigned int numberPointsToDraw, CoordinateType indexType, const void* firstIndexToRender ) const;
 	void DoRenderVertexArray( Shape drawingShape, unsigned int startingArrayIndex, unsigned int numberPointsInArray ) const;
+	void DoRenderVertexArrayInstanced( Shape drawingShape, unsigned int startingArrayIndex, unsigned int numberPointsInArray, unsigned int numberOfInstances ) const;
+	void DoSetGenericArrayInstanceDivisor( unsigned int variableLocation, unsigned int instancesPerElement ) const;
+	bool DoSupportsInstancing() const { return ( m_drawArraysInstanced != nullptr ) && ( m_vertexAttribDivisor != nullptr ); }
 	void DoSetPointerToColorArray( unsigned int coordinatesPerVertex, CoordinateType coordinateType, unsigned int gapBetweenVertices, const void* firstVertexInArray ) const;
 	void DoSetPointerToGenericArray( unsigned int variableLocation, int numberOfVertexCoordinates, CoordinateType coordinateType, bool normalizeData, unsigned int gapBetweenVertices, const void* firstVertexInArray ) const;
 	void DoSetPointerToTextureCoordinateArray( unsigned int coordinatesPerVertex, CoordinateType coordinateType, unsigned int gapBetweenVertices, const void* firstVertexInArray ) const;
@@ -87,7 +90,11 @@ public:
 
 private:
 	//Don't allow other Plebian programmers to call our singleton's constructor.
-	OGLES2RendererInterface() : RendererInterface() { }
+	OGLES2RendererInterface()
+		: RendererInterface()
+		, m_drawArraysInstanced( nullptr )
+		, m_vertexAttribDivisor( nullptr )
+	{ }
 
 	//Copy and assign are not allowed
 	OGLES2RendererInterface( const OGLES2RendererInterface& );
@@ -95,7 +102,11 @@ private:
 
 	GLenum ConvertFramebufferTargetToOpenGLEnum( Framebuffer::Target target );
 
-	void Initialize() { }
+	void Initialize();
+
+	//Instancing is core in ES3 and an extension in ES2, so these are looked up at startup
+	PFNGLDRAWARRAYSINSTANCEDEXTPROC m_drawArraysInstanced;
+	PFNGLVERTEXATTRIBDIVISOREXTPROC m_vertexAttribDivisor;
 };
 
 
@@ -410,6 +421,18 @@ inline void OGLES2RendererInterface::DoRenderVertexArray( Shape drawingShape, un
 	glDrawArrays( drawingShape, startingArrayIndex, numberPointsInArray );
 }
 
+//-----------------------------------------------------------------------------------------------
+inline void OGLES2RendererInterface::DoRenderVertexArrayInstanced( Shape drawingShape, unsigned int startingArrayIndex, unsigned int numberPointsInArray, unsigned int numberOfInstances ) const
+{
+	m_drawArraysInstanced( drawingShape, startingArrayIndex, numberPointsInArray, numberOfInstances );
+}
+
+//-----------------------------------------------------------------------------------------------
+inline void OGLES2RendererInterface::DoSetGenericArrayInstanceDivisor( unsigned int variableLocation, unsigned int instancesPerElement ) const
+{
+	m_vertexAttribDivisor( variableLocation, instancesPerElement );
+}
+
 //-----------------------------------------------------------------------------------------------
 inline void OGLES2RendererInterface::DoSetPointerToColorArray( unsigned int coordinatesPerVertex, CoordinateType coordinateType, unsigned int gapBetweenVertices, const void* firstVertexInArray ) const
 {
@@ -23,6 +23,10 @@ PFNGLFRAMEBUFFERRENDERBUFFERPROC glFramebufferRenderbuffer = nullptr;
 PFNGLFRAMEBUFFERTEXTURE2DPROC	 glFramebufferTexture2D = nullptr;
 PFNGLGENFRAMEBUFFERSPROC		 glGenFramebuffers = nullptr;
 
+//Instancing
+PFNGLDRAWARRAYSINSTANCEDPROC	glDrawArraysInstanced = nullptr;
+PFNGLVERTEXATTRIBDIVISORPROC	glVertexAttribDivisor = nullptr;
+
 //Mipmaps
 PFNGLGENERATEMIPMAPPROC	glGenerateMipmap = nullptr;
 
@@ -117,6 +121,14 @@ void OGLRendererInterface::InitializeOpenGLFunctionPointers()
 	glFramebufferTexture2D		= ( PFNGLFRAMEBUFFERTEXTURE2DPROC ) wglGetProcAddress( "glFramebufferTexture2D" );
 	glGenFramebuffers			= ( PFNGLGENFRAMEBUFFERSPROC ) wglGetProcAddress( "glGenFramebuffers" );
 
+	//Instancing (core in 3.3; the ARB extensions cover older drivers)
+	glDrawArraysInstanced		= ( PFNGLDRAWARRAYSINSTANCEDPROC ) wglGetProcAddress( "glDrawArraysInstanced" );
+	if( glDrawArraysInstanced == nullptr )
+		glDrawArraysInstanced	= ( PFNGLDRAWARRAYSINSTANCEDPROC ) wglGetProcAddress( "glDrawArraysInstancedARB" );
+	glVertexAttribDivisor		= ( PFNGLVERTEXATTRIBDIVISORPROC ) wglGetProcAddress( "glVertexAttribDivisor" );
+	if( glVertexAttribDivisor == nullptr )
+		glVertexAttribDivisor	= ( PFNGLVERTEXATTRIBDIVISORPROC ) wglGetProcAddress( "glVertexAttribDivisorARB" );
+
 	//Mipmaps
 	glGenerateMipmap = ( PFNGLGENERATEMIPMAPPROC ) wglGetProcAddress( "glGenerateMipmap" );
 
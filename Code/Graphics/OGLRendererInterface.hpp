@@ -35,6 +35,10 @@ extern PFNGLFRAMEBUFFERRENDERBUFFERPROC	glFramebufferRenderbuffer;
 extern PFNGLFRAMEBUFFERTEXTURE2DPROC	glFramebufferTexture2D;
 extern PFNGLGENFRAMEBUFFERSPROC			glGenFramebuffers;
 
+//Instancing
+extern PFNGLDRAWARRAYSINSTANCEDPROC	glDrawArraysInstanced;
+extern PFNGLVERTEXATTRIBDIVISORPROC	glVertexAttribDivisor;
+
 //Mipmaps
 extern PFNGLGENERATEMIPMAPPROC	glGenerateMipmap;
 
@@ -149,6 +153,9 @@ public:
 	//Vertex Arrays
 	void DoRenderPartOfArray( Shape drawingShape, unsigned int numberPointsToDraw, CoordinateType indexType, const void* firstIndexToRender ) const;
 	void DoRenderVertexArray( Shape drawingShape, unsigned int startingArrayIndex, unsigned int numberPointsInArray ) const;
+	void DoRenderVertexArrayInstanced( Shape drawingShape, unsigned int startingArrayIndex, unsigned int numberPointsInArray, unsigned int numberOfInstances ) const;
+	void DoSetGenericArrayInstanceDivisor( unsigned int variableLocation, unsigned int instancesPerElement ) const;
+	bool DoSupportsInstancing() const { return ( glDrawArraysInstanced != nullptr ) && ( glVertexAttribDivisor != nullptr ); }
 	void DoSetPointerToColorArray( unsigned int coordinatesPerVertex, CoordinateType coordinateType, unsigned int gapBetweenVertices, const void* firstVertexInArray ) const;
 	void DoSetPointerToGenericArray( unsigned int variableLocation, int numberOfVertexCoordinates, CoordinateType coordinateType, bool normalizeData, unsigned int gapBetweenVertices, const void* firstVertexInArray ) const;
 	void DoSetPointerToTextureCoordinateArray( unsigned int coordinatesPerVertex, CoordinateType coordinateType, unsigned int gapBetweenVertices, const void* firstVertexInArray ) const;
@@ -459,6 +466,18 @@ inline void OGLRendererInterface::DoRenderVertexArray( Shape drawingShape, unsig
 	glDrawArrays( drawingShape, startingArrayIndex, numberPointsInArray );
 }
 
+//-----------------------------------------------------------------------------------------------
+inline void OGLRendererInterface::DoRenderVertexArrayInstanced( Shape drawingShape, unsigned int startingArrayIndex, unsigned int numberPointsInArray, unsigned int numberOfInstances ) const
+{
+	glDrawArraysInstanced( drawingShape, startingArrayIndex, numberPointsInArray, numberOfInstances );
+}
+
+//-----------------------------------------------------------------------------------------------
+inline void OGLRendererInterface::DoSetGenericArrayInstanceDivisor( unsigned int variableLocation, unsigned int instancesPerElement ) const
+{
+	glVertexAttribDivisor( variableLocation, instancesPerElement );
+}
+
 //-----------------------------------------------------------------------------------------------
 inline void OGLRendererInterface::DoSetPointerToColorArray( unsigned int coordinatesPerVertex, CoordinateType coordinateType, unsigned int gapBetweenVertices, const void* firstVertexInArray ) const
 {
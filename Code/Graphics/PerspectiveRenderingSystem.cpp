@@ -2,9 +2,27 @@
 
 #include "../CameraComponent.hpp"
 #include "../Entity.hpp"
+#include "../Math/EngineMath.hpp"
+#include "Material.hpp"
 #include "MeshComponent.hpp"
 #include "RendererInterface.hpp"
 
+//-----------------------------------------------------------------------------------------------
+static bool HaveSameTextureBindings( const Material* first, const Material* second )
+{
+	if( first->infoForTextures.size() != second->infoForTextures.size() )
+		return false;
+
+	for( unsigned int i = 0; i < first->infoForTextures.size(); ++i )
+	{
+		const Material::TextureInfo& firstInfo = first->infoForTextures[ i ];
+		const Material::TextureInfo& secondInfo = second->infoForTextures[ i ];
+		if( firstInfo.texture != secondInfo.texture || firstInfo.textureUnitID != secondInfo.textureUnitID )
+			return false;
+	}
+	return true;
+}
+
 //-----------------------------------------------------------------------------------------------
 void PerspectiveRenderingSystem::OnAttachment( SystemManager* )
 {
@@ -14,62 +32,153 @@ void PerspectiveRenderingSystem::OnAttachment( SystemManager* )
 //-----------------------------------------------------------------------------------------------
 void PerspectiveRenderingSystem::OnEndFrame()
 {
-	for( unsigned int i = 0; i < m_meshes.size(); ++i )
-	{
-		if( m_meshes[ i ]->IsReadyForDeletion() )
-		{
-			delete m_meshes[ i ];
-			m_meshes.erase( m_meshes.begin() + i );
-		}
-	}
+	m_meshes.RemoveElementsReadyForDeletion();
 }
 
 //-----------------------------------------------------------------------------------------------
+/* Meshes are drawn in sort key order, and each piece of material state is only applied when it
+	differs from the mesh drawn before. Every skipped bind is counted in the frame's statistics.
+	Runs of meshes sharing both a material and flyweight vertex data are drawn as one instanced batch,
+	when the material's pipeline reads i_instanceModelMatrix (as BasicInstanced.330 does). */
 void PerspectiveRenderingSystem::OnRender() const
 {
 	//RendererInterface::SetViewMatrixToIdentity();
 	ViewWorldThroughCamera( m_activeCamera );
 
-	for( unsigned int i = 0; i < m_meshes.size(); ++i )
+	const FloatVector3 cameraPosition = m_activeCamera->owner->GetInterpolatedPosition( m_interpolationAlpha );
+	const float squaredFarClippingPlane = static_cast< float >( m_farClippingPlane * m_farClippingPlane );
+
+	m_renderQueue.Clear();
+	for( unsigned int i = 0; i < m_meshes.GetNumberOfElements(); ++i )
 	{
-		RenderMeshComponent( m_meshes[ i ] );
+		const MeshComponent* mesh = m_meshes[ i ];
+		float squaredDistance = CalculateSquaredDistanceBetween( cameraPosition, mesh->owner->GetInterpolatedPosition( m_interpolationAlpha ) );
+		m_renderQueue.Submit( mesh, squaredDistance / squaredFarClippingPlane );
 	}
+	m_renderQueue.Sort();
+
+	RenderQueueStatistics statistics;
+	const Material* previousMaterial = nullptr;
+	RenderQueue::SortKey previousKey = 0;
+	bool canDrawInstanced = false;
+	for( unsigned int i = 0; i < m_renderQueue.GetNumberOfItems(); ++i )
+	{
+		const RenderQueue::Item& item = m_renderQueue.GetItem( i );
+		const Material* material = item.mesh->material;
+
+		bool pipelineChanged = ( previousMaterial == nullptr ) || !RenderQueue::HaveSamePipeline( previousKey, item.key );
+		bool materialChanged = pipelineChanged || !RenderQueue::HaveSameMaterial( previousKey, item.key );
+		bool texturesChanged = ( previousMaterial == nullptr ) || !RenderQueue::HaveSameFirstTexture( previousKey, item.key ) ||
+								!HaveSameTextureBindings( previousMaterial, material );
+
+		if( pipelineChanged )
+		{
+			RendererInterface::ApplyMaterialPipeline( material );
+			canDrawInstanced = RendererInterface::CanDrawInstanced( material );
+			++statistics.pipelineBinds;
+		}
+		else
+			++statistics.pipelineBindsSaved;
+
+		if( materialChanged )
+		{
+			RendererInterface::ApplyMaterialUniforms( material );
+			++statistics.materialBinds;
+		}
+		else
+			++statistics.materialBindsSaved;
+
+		if( texturesChanged )
+		{
+			RendererInterface::ApplyMaterialTextures( material );
+			++statistics.textureBinds;
+		}
+		else
+			++statistics.textureBindsSaved;
+
+		unsigned int endOfRun = i + 1;
+		while( canDrawInstanced && endOfRun < m_renderQueue.GetNumberOfItems() &&
+			RenderQueue::HaveSameMaterial( item.key, m_renderQueue.GetItem( endOfRun ).key ) &&
+			RenderQueue::HaveSameFlyweightVertexData( item.key, m_renderQueue.GetItem( endOfRun ).key ) )
+		{
+			++endOfRun;
+		}
+
+		if( endOfRun - i > 1 )
+		{
+			RenderMeshInstances( i, endOfRun - i );
+			++statistics.instancedBatches;
+			statistics.instancedMeshes += endOfRun - i;
+			i = endOfRun - 1;
+		}
+		else
+			RenderMeshComponent( item.mesh );
+		++statistics.numberOfDraws;
+
+		previousMaterial = material;
+		previousKey = m_renderQueue.GetItem( i ).key;
+	}
+
+	if( previousMaterial != nullptr )
+		RendererInterface::RemoveMaterial( previousMaterial );
+	m_lastFrameStatistics = statistics;
 }
 
 //-----------------------------------------------------------------------------------------------
 void PerspectiveRenderingSystem::OnDestruction()
 {
-	for( unsigned int i = 0; i < m_meshes.size(); ++i )
-	{
-		delete m_meshes[ i ];
-	}
-	m_meshes.clear();
+	m_meshes.ReleaseAllElements();
 }
 
 //-----------------------------------------------------------------------------------------------
-void PerspectiveRenderingSystem::RenderMeshComponent( const MeshComponent* mesh ) const
+//Leaves the mesh's model matrix on top of the stack; the caller pops it
+void PerspectiveRenderingSystem::PushMeshTransform( const MeshComponent* mesh ) const
 {
 	static const FloatVector3 X_AXIS( 1.f, 0.f, 0.f );
 	static const FloatVector3 Y_AXIS( 0.f, 1.f, 0.f );
 	static const FloatVector3 Z_AXIS( 0.f, 0.f, 1.f );
 	
+	const EulerAngles ownerOrientation = mesh->owner->GetOrientation();
+
 	RendererInterface::PushMatrix();
-	RendererInterface::TranslateWorld( mesh->owner->position );
-	RendererInterface::RotateWorldAboutAxisDegrees( Z_AXIS, mesh->owner->orientation.yawDegreesAboutZ );
-	RendererInterface::RotateWorldAboutAxisDegrees( Y_AXIS, mesh->owner->orientation.pitchDegreesAboutY );
-	RendererInterface::RotateWorldAboutAxisDegrees( X_AXIS, mesh->owner->orientation.rollDegreesAboutX );
+	RendererInterface::TranslateWorld( mesh->owner->GetInterpolatedPosition( m_interpolationAlpha ) );
+	RendererInterface::RotateWorldAboutAxisDegrees( Z_AXIS, ownerOrientation.yawDegreesAboutZ );
+	RendererInterface::RotateWorldAboutAxisDegrees( Y_AXIS, ownerOrientation.pitchDegreesAboutY );
+	RendererInterface::RotateWorldAboutAxisDegrees( X_AXIS, ownerOrientation.rollDegreesAboutX );
+}
+
+//-----------------------------------------------------------------------------------------------
+//Expects the mesh's material to have been applied already, apart from its model matrix
+void PerspectiveRenderingSystem::RenderMeshComponent( const MeshComponent* mesh ) const
+{
+	PushMeshTransform( mesh );
 
 	//RendererInterface::BindVertexDataToShader( mesh->vertexData );
-	RendererInterface::ApplyMaterial( mesh->material );
+	RendererInterface::ApplyMaterialModelMatrix( mesh->material );
 
 	RendererInterface::RenderVertexArray( mesh->vertexData->shape, 0, mesh->vertexData->numberOfVertices );
 
-	RendererInterface::RemoveMaterial( mesh->material );
 	//RendererInterface::UnbindVertexData( mesh->vertexData );
 
 	RendererInterface::PopMatrix();
 }
 
+//-----------------------------------------------------------------------------------------------
+//The queued meshes must all share one material and one flyweight vertex data, already applied
+void PerspectiveRenderingSystem::RenderMeshInstances( unsigned int firstItemIndex, unsigned int numberOfItems ) const
+{
+	m_instanceModelMatrices.resize( numberOfItems );
+	for( unsigned int i = 0; i < numberOfItems; ++i )
+	{
+		PushMeshTransform( m_renderQueue.GetItem( firstItemIndex + i ).mesh );
+		m_instanceModelMatrices[ i ] = RendererInterface::GetModelMatrix();
+		RendererInterface::PopMatrix();
+	}
+
+	const MeshComponent* firstMesh = m_renderQueue.GetItem( firstItemIndex ).mesh;
+	RendererInterface::RenderVertexDataInstanced( firstMesh->vertexData, firstMesh->material, &m_instanceModelMatrices[ 0 ], numberOfItems );
+}
+
 //-----------------------------------------------------------------------------------------------
 void PerspectiveRenderingSystem::ViewWorldThroughCamera( const CameraComponent* camera ) const
 {
@@ -95,7 +204,7 @@ void PerspectiveRenderingSystem::ViewWorldThroughCamera( const CameraComponent*
 		break;
 	}
 	Float4x4Matrix rotationMatrix = F4X4_IDENTITY_MATRIX;
-	const EulerAngles& cameraOrientation = camera->owner->orientation;
+	const EulerAngles cameraOrientation = camera->owner->GetOrientation();
 	Float4x4Matrix xRotation, yRotation, zRotation, x2, z2; 
 	GetRotationMatrixForAxisAndAngleDegrees( xRotation, FloatVector3( 1.f, 0.f, 0.f ), -cameraOrientation.rollDegreesAboutX );
 	GetRotationMatrixForAxisAndAngleDegrees( yRotation, FloatVector3( 0.f, 1.f, 0.f ), -cameraOrientation.pitchDegreesAboutY );
@@ -105,7 +214,7 @@ void PerspectiveRenderingSystem::ViewWorldThroughCamera( const CameraComponent*
 	rotationMatrix = zRotation * yRotation * xRotation * z2 * x2;
 
 	Float4x4Matrix translationMatrix = F4X4_IDENTITY_MATRIX;
-	const FloatVector3& cameraPosition = camera->owner->position;
+	const FloatVector3 cameraPosition = camera->owner->GetInterpolatedPosition( m_interpolationAlpha );
 	translationMatrix[ 12 ] = -cameraPosition.x;
 	translationMatrix[ 13 ] = -cameraPosition.y;
 	translationMatrix[ 14 ] = -cameraPosition.z;
@@ -5,7 +5,9 @@
 //-----------------------------------------------------------------------------------------------
 #include <vector>
 
+#include "../Math/Float4x4Matrix.hpp"
 #include "RenderingSystem.hpp"
+#include "RenderQueue.hpp"
 
 struct MeshComponent;
 
@@ -19,6 +21,8 @@ public:
 	PerspectiveRenderingSystem( double horizFOVDegrees, double aspectRatio,
 								double nearClipPlane, double farClipPlane );
 
+	const RenderQueueStatistics& GetLastFrameStatistics() const { return m_lastFrameStatistics; }
+
 
 protected: //For use only by SystemManager
 	void OnAttachment( SystemManager* manager );
@@ -28,7 +32,9 @@ protected: //For use only by SystemManager
 
 
 private:
+	void PushMeshTransform( const MeshComponent* mesh ) const;
 	void RenderMeshComponent( const MeshComponent* mesh ) const;
+	void RenderMeshInstances( unsigned int firstItemIndex, unsigned int numberOfItems ) const;
 	void ViewWorldThroughCamera( const CameraComponent* camera ) const;
 
 	//Perspective Settings
@@ -36,6 +42,11 @@ private:
 	double m_aspectRatio;
 	double m_nearClippingPlane;
 	double m_farClippingPlane;
+
+	//Rebuilt every OnRender
+	mutable RenderQueue m_renderQueue;
+	mutable RenderQueueStatistics m_lastFrameStatistics;
+	mutable std::vector< Float4x4Matrix > m_instanceModelMatrices;
 };
 
 
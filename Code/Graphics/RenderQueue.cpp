@@ -0,0 +1,250 @@
+#include "RenderQueue.hpp"
+
+#include "../EngineMacros.hpp"
+#include "Material.hpp"
+#include "MeshComponent.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+static RenderQueue::SortKey GetMaskOfLowestBits( unsigned int numberOfBits )
+{
+	return ( static_cast< RenderQueue::SortKey >( 1 ) << numberOfBits ) - 1;
+}
+
+//-----------------------------------------------------------------------------------------------
+RenderQueue::RenderQueue()
+	: m_pipelineIDs( static_cast< unsigned int >( GetMaskOfLowestBits( PIPELINE_BITS ) ) )
+	, m_materialIDs( static_cast< unsigned int >( GetMaskOfLowestBits( MATERIAL_BITS ) ) )
+	, m_textureIDs( static_cast< unsigned int >( GetMaskOfLowestBits( TEXTURE_BITS ) ) )
+	, m_vertexDataIDs( static_cast< unsigned int >( GetMaskOfLowestBits( VERTEX_DATA_BITS ) ) )
+{ }
+
+//-----------------------------------------------------------------------------------------------
+void RenderQueue::Clear()
+{
+	m_items.clear();
+	m_pipelineIDs.Clear();
+	m_materialIDs.Clear();
+	m_textureIDs.Clear();
+	m_vertexDataIDs.Clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+void RenderQueue::Submit( const MeshComponent* mesh, float depthZeroToOne )
+{
+	static const unsigned int TEXTURE_SHIFT = 0;
+	static const unsigned int MATERIAL_SHIFT = TEXTURE_SHIFT + TEXTURE_BITS;
+	static const unsigned int PIPELINE_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+	static const unsigned int STATE_BITS = PIPELINE_SHIFT + PIPELINE_BITS;
+
+	const Material* material = mesh->material;
+	const Texture* firstTexture = material->infoForTextures.empty() ? nullptr : material->infoForTextures[ 0 ].texture;
+
+	SortKey stateBits = static_cast< SortKey >( m_textureIDs.GetOrAssignID( firstTexture ) ) << TEXTURE_SHIFT;
+	stateBits |= static_cast< SortKey >( m_materialIDs.GetOrAssignID( material ) ) << MATERIAL_SHIFT;
+	stateBits |= static_cast< SortKey >( m_pipelineIDs.GetOrAssignID( material->pipeline ) ) << PIPELINE_SHIFT;
+
+	if( depthZeroToOne < 0.f )
+		depthZeroToOne = 0.f;
+	else if( depthZeroToOne > 1.f )
+		depthZeroToOne = 1.f;
+
+	Item item;
+	item.key = static_cast< SortKey >( material->renderPass ) << ( 64 - PASS_BITS );
+	if( material->renderPass == Material::PASS_Translucent )
+	{
+		SortKey depthBits = static_cast< SortKey >( depthZeroToOne * static_cast< float >( GetMaskOfLowestBits( DEPTH_BITS ) ) );
+		item.key |= ( ( GetMaskOfLowestBits( DEPTH_BITS ) - depthBits ) << STATE_BITS ) | stateBits;
+	}
+	else
+	{
+		const void* sharedVertexData = mesh->vertexDataIsFlyweight ? mesh->vertexData : nullptr;
+		SortKey vertexDataBits = static_cast< SortKey >( m_vertexDataIDs.GetOrAssignID( sharedVertexData ) );
+		SortKey depthBits = static_cast< SortKey >( depthZeroToOne * static_cast< float >( GetMaskOfLowestBits( OPAQUE_DEPTH_BITS ) ) );
+		item.key |= ( ( ( stateBits << VERTEX_DATA_BITS ) | vertexDataBits ) << OPAQUE_DEPTH_BITS ) | depthBits;
+	}
+	item.mesh = mesh;
+	m_items.push_back( item );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Least significant byte first; bytes that are the same in every key (such as the unused bits
+	under the pass) are skipped. */
+void RenderQueue::Sort()
+{
+	static const unsigned int BITS_PER_DIGIT = 8;
+	static const unsigned int NUMBER_OF_BUCKETS = 1 << BITS_PER_DIGIT;
+
+	unsigned int numberOfItems = m_items.size();
+	if( numberOfItems < 2 )
+		return;
+
+	m_sortScratch.resize( numberOfItems );
+	Item* sourceItems = &m_items[ 0 ];
+	Item* sortedItems = &m_sortScratch[ 0 ];
+
+	for( unsigned int shift = 0; shift < 64; shift += BITS_PER_DIGIT )
+	{
+		unsigned int bucketStarts[ NUMBER_OF_BUCKETS ] = { 0 };
+		for( unsigned int i = 0; i < numberOfItems; ++i )
+			++bucketStarts[ ( sourceItems[ i ].key >> shift ) & ( NUMBER_OF_BUCKETS - 1 ) ];
+
+		if( bucketStarts[ ( sourceItems[ 0 ].key >> shift ) & ( NUMBER_OF_BUCKETS - 1 ) ] == numberOfItems )
+			continue;
+
+		unsigned int numberOfItemsBeforeBucket = 0;
+		for( unsigned int bucket = 0; bucket < NUMBER_OF_BUCKETS; ++bucket )
+		{
+			unsigned int numberOfItemsInBucket = bucketStarts[ bucket ];
+			bucketStarts[ bucket ] = numberOfItemsBeforeBucket;
+			numberOfItemsBeforeBucket += numberOfItemsInBucket;
+		}
+
+		for( unsigned int i = 0; i < numberOfItems; ++i )
+			sortedItems[ bucketStarts[ ( sourceItems[ i ].key >> shift ) & ( NUMBER_OF_BUCKETS - 1 ) ]++ ] = sourceItems[ i ];
+
+		Item* swapTemp = sourceItems;
+		sourceItems = sortedItems;
+		sortedItems = swapTemp;
+	}
+
+	if( sourceItems != &m_items[ 0 ] )
+		m_items.swap( m_sortScratch );
+}
+
+#pragma region Key Fields
+//-----------------------------------------------------------------------------------------------
+STATIC bool RenderQueue::HaveSamePipeline( SortKey first, SortKey second )
+{
+	unsigned int pipelineID = GetPipelineID( first );
+	return ( GetPass( first ) == GetPass( second ) ) && ( pipelineID == GetPipelineID( second ) ) && ( pipelineID != GetMaskOfLowestBits( PIPELINE_BITS ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC bool RenderQueue::HaveSameMaterial( SortKey first, SortKey second )
+{
+	unsigned int materialID = GetMaterialID( first );
+	return HaveSamePipeline( first, second ) && ( materialID == GetMaterialID( second ) ) && ( materialID != GetMaskOfLowestBits( MATERIAL_BITS ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC bool RenderQueue::HaveSameFirstTexture( SortKey first, SortKey second )
+{
+	unsigned int textureID = GetTextureID( first );
+	return ( textureID == GetTextureID( second ) ) && ( textureID != GetMaskOfLowestBits( TEXTURE_BITS ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC bool RenderQueue::HaveSameFlyweightVertexData( SortKey first, SortKey second )
+{
+	unsigned int vertexDataID = GetVertexDataID( first );
+	return ( vertexDataID == GetVertexDataID( second ) ) && ( vertexDataID != 0 ) && ( vertexDataID != GetMaskOfLowestBits( VERTEX_DATA_BITS ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC unsigned int RenderQueue::GetStateShift( SortKey key )
+{
+	if( GetPass( key ) == Material::PASS_Translucent )
+		return 0;
+	return VERTEX_DATA_BITS + OPAQUE_DEPTH_BITS;
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC unsigned int RenderQueue::GetPipelineID( SortKey key )
+{
+	return static_cast< unsigned int >( ( key >> ( GetStateShift( key ) + TEXTURE_BITS + MATERIAL_BITS ) ) & GetMaskOfLowestBits( PIPELINE_BITS ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC unsigned int RenderQueue::GetMaterialID( SortKey key )
+{
+	return static_cast< unsigned int >( ( key >> ( GetStateShift( key ) + TEXTURE_BITS ) ) & GetMaskOfLowestBits( MATERIAL_BITS ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC unsigned int RenderQueue::GetTextureID( SortKey key )
+{
+	return static_cast< unsigned int >( ( key >> GetStateShift( key ) ) & GetMaskOfLowestBits( TEXTURE_BITS ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC unsigned int RenderQueue::GetVertexDataID( SortKey key )
+{
+	if( GetPass( key ) == Material::PASS_Translucent )
+		return 0;
+	return static_cast< unsigned int >( ( key >> OPAQUE_DEPTH_BITS ) & GetMaskOfLowestBits( VERTEX_DATA_BITS ) );
+}
+#pragma endregion //Key Fields
+
+#pragma region Pointer ID Table
+//-----------------------------------------------------------------------------------------------
+RenderQueue::PointerIDTable::PointerIDTable( unsigned int largestID )
+	: m_numberOfEntries( 0 )
+	, m_largestID( largestID )
+{
+	static const unsigned int STARTING_NUMBER_OF_ENTRIES = 64;
+
+	Entry emptyEntry = { nullptr, 0 };
+	m_entries.resize( STARTING_NUMBER_OF_ENTRIES, emptyEntry );
+}
+
+//-----------------------------------------------------------------------------------------------
+void RenderQueue::PointerIDTable::Clear()
+{
+	if( m_numberOfEntries == 0 )
+		return;
+
+	Entry emptyEntry = { nullptr, 0 };
+	m_entries.assign( m_entries.size(), emptyEntry );
+	m_numberOfEntries = 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+unsigned int RenderQueue::PointerIDTable::GetOrAssignID( const void* pointer )
+{
+	if( pointer == nullptr )
+		return 0;
+
+	unsigned int entryIndex = FindEntryIndex( pointer );
+	if( m_entries[ entryIndex ].pointer != nullptr )
+		return m_entries[ entryIndex ].id;
+
+	//Kept at most half full so probe runs stay short
+	if( 2 * ( m_numberOfEntries + 1 ) > m_entries.size() )
+	{
+		Grow();
+		entryIndex = FindEntryIndex( pointer );
+	}
+
+	++m_numberOfEntries;
+	m_entries[ entryIndex ].pointer = pointer;
+	m_entries[ entryIndex ].id = ( m_numberOfEntries < m_largestID ) ? m_numberOfEntries : m_largestID;
+	return m_entries[ entryIndex ].id;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RenderQueue::PointerIDTable::Grow()
+{
+	std::vector< Entry > oldEntries;
+	oldEntries.swap( m_entries );
+
+	Entry emptyEntry = { nullptr, 0 };
+	m_entries.resize( oldEntries.size() * 2, emptyEntry );
+	for( unsigned int i = 0; i < oldEntries.size(); ++i )
+	{
+		if( oldEntries[ i ].pointer != nullptr )
+			m_entries[ FindEntryIndex( oldEntries[ i ].pointer ) ] = oldEntries[ i ];
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+//Returns the pointer's entry, or the empty entry where it would go
+unsigned int RenderQueue::PointerIDTable::FindEntryIndex( const void* pointer ) const
+{
+	unsigned int indexMask = m_entries.size() - 1;
+	unsigned int entryIndex = ( static_cast< unsigned int >( reinterpret_cast< size_t >( pointer ) >> 3 ) * 2654435761u ) & indexMask;
+	while( m_entries[ entryIndex ].pointer != nullptr && m_entries[ entryIndex ].pointer != pointer )
+		entryIndex = ( entryIndex + 1 ) & indexMask;
+	return entryIndex;
+}
+#pragma endregion //Pointer ID Table
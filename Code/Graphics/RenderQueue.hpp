@@ -0,0 +1,138 @@
+#pragma once
+#ifndef INCLUDED_RENDER_QUEUE_HPP
+#define INCLUDED_RENDER_QUEUE_HPP
+
+//-----------------------------------------------------------------------------------------------
+#include <vector>
+
+struct Material;
+struct MeshComponent;
+
+
+//-----------------------------------------------------------------------------------------------
+struct RenderQueueStatistics
+{
+	RenderQueueStatistics()
+		: numberOfDraws( 0 )
+		, pipelineBinds( 0 )
+		, pipelineBindsSaved( 0 )
+		, materialBinds( 0 )
+		, materialBindsSaved( 0 )
+		, textureBinds( 0 )
+		, textureBindsSaved( 0 )
+		, instancedBatches( 0 )
+		, instancedMeshes( 0 )
+	{ }
+
+	unsigned int GetBindsSaved() const { return pipelineBindsSaved + materialBindsSaved + textureBindsSaved; }
+
+	//Data Members
+	unsigned int numberOfDraws;
+	unsigned int pipelineBinds;
+	unsigned int pipelineBindsSaved;
+	unsigned int materialBinds;
+	unsigned int materialBindsSaved;
+	unsigned int textureBinds;
+	unsigned int textureBindsSaved;
+	unsigned int instancedBatches;
+	unsigned int instancedMeshes; //Meshes drawn as part of an instanced batch
+};
+
+
+
+//-----------------------------------------------------------------------------------------------
+/* One frame's meshes, each with a 64-bit key that sorts them so meshes sharing state are drawn
+	next to each other. Keys are radix sorted, so sorting costs the same whatever order the meshes
+	were submitted in.
+
+	Pipelines, materials and textures are numbered densely in the order they're first submitted
+	each frame, so they fit in a few bits. Two neighbouring keys with the same number in a field
+	are known to share that state, except for the field's largest number, which is given to
+	everything past the field's capacity and so never counts as shared.
+
+	Meshes whose vertex data is a flyweight also get its number, so meshes that can be drawn as
+	instances of each other end up next to each other. Translucent meshes have to be drawn in
+	depth order anyway, so they leave it out and keep a finer depth instead.
+
+	Key layout, most significant bits first:
+		Opaque and overlay:	pass (4) | pipeline (8) | material (12) | texture (12) | vertex data (12) | depth (16)
+		Translucent:		pass (4) | far-to-near depth (24) | pipeline (8) | material (12) | texture (12) */
+class RenderQueue
+{
+public:
+	typedef unsigned long long SortKey;
+
+	static const unsigned int PASS_BITS		= 4;
+	static const unsigned int PIPELINE_BITS	= 8;
+	static const unsigned int MATERIAL_BITS	= 12;
+	static const unsigned int TEXTURE_BITS	= 12;
+	static const unsigned int VERTEX_DATA_BITS	= 12;
+	static const unsigned int DEPTH_BITS	= 24;
+	static const unsigned int OPAQUE_DEPTH_BITS	= 16;
+
+	struct Item
+	{
+		SortKey key;
+		const MeshComponent* mesh;
+	};
+
+	RenderQueue();
+
+	void Clear();
+	void Submit( const MeshComponent* mesh, float depthZeroToOne );
+	void Sort();
+
+	unsigned int GetNumberOfItems() const { return m_items.size(); }
+	const Item& GetItem( unsigned int itemIndex ) const { return m_items[ itemIndex ]; }
+
+	//Key Comparisons
+	static bool HaveSamePipeline( SortKey first, SortKey second );
+	static bool HaveSameMaterial( SortKey first, SortKey second );
+	static bool HaveSameFirstTexture( SortKey first, SortKey second );
+	static bool HaveSameFlyweightVertexData( SortKey first, SortKey second );
+
+
+private:
+	//-------------------------------------------------------------------------------------------
+	/* Open addressed, so clearing it each frame doesn't free anything. */
+	class PointerIDTable
+	{
+	public:
+		PointerIDTable( unsigned int largestID );
+
+		void Clear();
+		unsigned int GetOrAssignID( const void* pointer ); //nullptr is always 0
+
+	private:
+		struct Entry
+		{
+			const void* pointer;
+			unsigned int id;
+		};
+
+		void Grow();
+		unsigned int FindEntryIndex( const void* pointer ) const;
+
+		std::vector< Entry > m_entries; //Size is always a power of two
+		unsigned int m_numberOfEntries;
+		unsigned int m_largestID;
+	};
+
+	//Key Fields
+	static unsigned int GetPass( SortKey key ) { return static_cast< unsigned int >( key >> ( 64 - PASS_BITS ) ); }
+	static unsigned int GetPipelineID( SortKey key );
+	static unsigned int GetMaterialID( SortKey key );
+	static unsigned int GetTextureID( SortKey key );
+	static unsigned int GetVertexDataID( SortKey key ); //0 if the mesh's vertex data isn't shared
+	static unsigned int GetStateShift( SortKey key );
+
+	//Data Members
+	std::vector< Item > m_items;
+	std::vector< Item > m_sortScratch;
+	PointerIDTable m_pipelineIDs;
+	PointerIDTable m_materialIDs;
+	PointerIDTable m_textureIDs;
+	PointerIDTable m_vertexDataIDs;
+};
+
+#endif //INCLUDED_RENDER_QUEUE_HPP
@@ -43,6 +43,11 @@ STATIC const RendererInterface::DefaultAttributeName RendererInterface::DEFAULT_
 STATIC const RendererInterface::DefaultAttributeName RendererInterface::DEFAULT_NAME_Bitangent		= "i_textureBitangent";
 STATIC const RendererInterface::DefaultAttributeName RendererInterface::DEFAULT_NAME_BoneIndex0		= "i_tendons[0].boneIndex";
 STATIC const RendererInterface::DefaultAttributeName RendererInterface::DEFAULT_NAME_BoneWeight0	= "i_tendons[0].boneWeight";
+STATIC const RendererInterface::DefaultAttributeName RendererInterface::DEFAULT_NAME_InstanceModelMatrix = "i_instanceModelMatrix";
+
+STATIC const RendererInterface::DefaultUniformName RendererInterface::DEFAULT_UNIFORM_ModelMatrix		= "u_modelMatrix";
+STATIC const RendererInterface::DefaultUniformName RendererInterface::DEFAULT_UNIFORM_ViewMatrix		= "u_viewMatrix";
+STATIC const RendererInterface::DefaultUniformName RendererInterface::DEFAULT_UNIFORM_ProjectionMatrix	= "u_projectionMatrix";
 
 //-----------------------------------------------------------------------------------------------
 STATIC RendererInterface* RendererInterface::s_activeRendererInterface = nullptr;
@@ -126,6 +131,9 @@ STATIC void RendererInterface::Shutdown()
 	delete s_activeRendererInterface->m_activeShaderLoader;
 	delete s_activeRendererInterface->m_activeTextureManager;
 
+	if( s_activeRendererInterface->m_instanceMatrixBufferID != 0 )
+		DeleteBufferObject( s_activeRendererInterface->m_instanceMatrixBufferID );
+
 	delete s_activeRendererInterface;
 }
 
@@ -172,36 +180,84 @@ STATIC Material* RendererInterface::CreateOrGetNewMaterial( const std::wstring&
 	return s_activeRendererInterface->m_materials[ materialName ];
 }
 
+//-----------------------------------------------------------------------------------------------
+/* A material's own slot wins over the pipeline's standard one; shaders that don't use the matrix
+	at all have neither, and it's skipped. */
+static void SetMatrixUniformInSlot( CachingShaderLoader* shaderLoader, const ShaderReflection& reflection,
+	ShaderReflection::Slot materialSlot, ShaderReflection::Slot standardSlot, const Float4x4Matrix& matrix )
+{
+	ShaderReflection::Slot slot = ( materialSlot != ShaderReflection::SLOT_None ) ? materialSlot : standardSlot;
+	ShaderVariable* matrixVariable = reflection.GetUniform( slot );
+	if( matrixVariable != nullptr )
+		shaderLoader->SetUniform( matrixVariable, matrix );
+}
+
 //-----------------------------------------------------------------------------------------------
 STATIC void RendererInterface::ApplyMaterial( const Material* material )
+{
+	ApplyMaterialPipeline( material );
+	ApplyMaterialUniforms( material );
+	ApplyMaterialTextures( material );
+	ApplyMaterialModelMatrix( material );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Uniforms belong to the program, so everything set by ApplyMaterialUniforms and
+	ApplyMaterialModelMatrix must be set again after this. */
+STATIC void RendererInterface::ApplyMaterialPipeline( const Material* material )
+{
+	UseShaderPipeline( material->pipeline );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Materials sharing a pipeline can name different view and projection uniforms, so those are
+	set here with the rest of the material rather than once per pipeline. */
+STATIC void RendererInterface::ApplyMaterialUniforms( const Material* material )
 {
 	CachingShaderLoader* shaderLoader = s_activeRendererInterface->m_activeShaderLoader;
-	const ShaderPipeline* const& pipeline = material->pipeline;
+	const ShaderReflection& reflection = shaderLoader->GetPipelineReflection( material->pipeline );
 
-	shaderLoader->UseShaderPipeline( pipeline );
+	SetMatrixUniformInSlot( shaderLoader, reflection, material->viewMatrixUniformSlot, reflection.viewMatrixSlot, GetViewMatrix() );
+	SetMatrixUniformInSlot( shaderLoader, reflection, material->projectionMatrixUniformSlot, reflection.projectionMatrixSlot, GetProjectionMatrix() );
 
- 	ShaderVariable* modelVariable = shaderLoader->GetUniformVariable( pipeline, "u_modelMatrix" );
- 	shaderLoader->SetUniform( modelVariable, GetModelMatrix() );
- 	delete modelVariable;
- 
- 	ShaderVariable* viewVariable = shaderLoader->GetUniformVariable( pipeline, "u_viewMatrix" );
- 	shaderLoader->SetUniform( viewVariable, GetViewMatrix() );
- 	delete viewVariable;
+	for( unsigned int i = 0; i < material->infoForTextures.size(); ++i )
+	{
+		const Material::TextureInfo& texInfo = material->infoForTextures[ i ];
+
+		ShaderVariable* samplerVariable = reflection.GetUniform( texInfo.samplerUniformSlot );
+		if( samplerVariable != nullptr )
+			shaderLoader->SetTextureUnitUniform( samplerVariable, texInfo.textureUnitID );
+	}
 
-	ShaderVariable* projectionVariable = shaderLoader->GetUniformVariable( pipeline, "u_projectionMatrix" );
-	shaderLoader->SetUniform( projectionVariable, GetProjectionMatrix() );
-	delete projectionVariable;
+	SetLineWidth( material->lineWidth );
+}
 
+//-----------------------------------------------------------------------------------------------
+STATIC void RendererInterface::ApplyMaterialTextures( const Material* material )
+{
 	for( unsigned int i = 0; i < material->infoForTextures.size(); ++i )
 	{
 		const Material::TextureInfo& texInfo = material->infoForTextures[ i ];
 
-		shaderLoader->SetTextureUnitUniform( texInfo.samplerUniformVariable, texInfo.textureUnitID );
 		SetActiveTextureUnit( texInfo.textureUnitID );
 		BindTexture( RendererInterface::TEXTURES_2D, texInfo.texture );
 	}
+}
 
-	SetLineWidth( material->lineWidth );
+//-----------------------------------------------------------------------------------------------
+STATIC void RendererInterface::ApplyMaterialModelMatrix( const Material* material )
+{
+	CachingShaderLoader* shaderLoader = s_activeRendererInterface->m_activeShaderLoader;
+	const ShaderReflection& reflection = shaderLoader->GetPipelineReflection( material->pipeline );
+
+	SetMatrixUniformInSlot( shaderLoader, reflection, material->modelMatrixUniformSlot, reflection.modelMatrixSlot, GetModelMatrix() );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC void RendererInterface::UseShaderPipeline( const ShaderPipeline* pipeline )
+{
+	if( s_activeRendererInterface->m_stateCache.UpdateShaderPipeline( pipeline ) )
+		s_activeRendererInterface->m_activeShaderLoader->UseShaderPipeline( pipeline );
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -221,21 +277,24 @@ STATIC void RendererInterface::RemoveMaterial( const Material* material )
 STATIC void RendererInterface::BindVertexDataToShader( const VertexData* vertData, const ShaderPipeline* pipeline )
 {
 	CachingShaderLoader*& shaderLoader = s_activeRendererInterface->m_activeShaderLoader;
+	const ShaderReflection& reflection = shaderLoader->GetPipelineReflection( pipeline );
 
 	BindBufferObject( ARRAY_BUFFER, vertData->bufferID );
 
 	size_t vertDataLocation = !vertData->IsBuffered() * reinterpret_cast< size_t >( vertData->data );
+	const ShaderReflection::Slot* attributeSlots = vertData->GetAttributeSlotsInPipeline( pipeline, reflection );
 	unsigned int numberOfAttributes = vertData->attributes.size();
 	for( unsigned int i = 0; i < numberOfAttributes; ++i )
 	{
 		const VertexAttribute& attribute = vertData->attributes[ i ];
-		ShaderVariable* attributeVariable = shaderLoader->GetAttributeVariable( pipeline, attribute.shaderVariableName );
+		ShaderVariable* attributeVariable = reflection.GetAttribute( attributeSlots[ i ] );
+		if( attributeVariable == nullptr )
+			continue;
 
 		shaderLoader->BindVertexArrayToVariable( attributeVariable, attribute.numberOfComponents, attribute.coordinateType,
 			attribute.normalizeFixedPointData, attribute.bytesUntilNextInstance, 
 			reinterpret_cast<void*>( vertDataLocation + attribute.attributeOffsetInStructure ) );
 		shaderLoader->EnableAttributeVariableInShader( attributeVariable );
-		delete attributeVariable;
 	}
 }
 
@@ -252,20 +311,237 @@ STATIC void RendererInterface::BufferVertexData( const VertexData* vertData )
 STATIC void RendererInterface::UnbindVertexDataFromShader( const VertexData* vertData, const ShaderPipeline* pipeline )
 {
 	CachingShaderLoader*& shaderLoader = s_activeRendererInterface->m_activeShaderLoader;
+	const ShaderReflection& reflection = shaderLoader->GetPipelineReflection( pipeline );
 
 	BindBufferObject( ARRAY_BUFFER, vertData->bufferID );
 
+	const ShaderReflection::Slot* attributeSlots = vertData->GetAttributeSlotsInPipeline( pipeline, reflection );
 	unsigned int numberOfAttributes = vertData->attributes.size();
 	for( unsigned int i = 0; i < numberOfAttributes; ++i )
 	{
-		const VertexAttribute& attribute = vertData->attributes[ i ];
-		ShaderVariable* attributeVariable = shaderLoader->GetAttributeVariable( pipeline, attribute.shaderVariableName );
+		ShaderVariable* attributeVariable = reflection.GetAttribute( attributeSlots[ i ] );
+		if( attributeVariable != nullptr )
+			shaderLoader->DisableAttributeVariableInShader( attributeVariable );
+	}
+
+	//No need to unbind the buffer; the following vertexes should take care of that.
+}
+
+//-----------------------------------------------------------------------------------------------
+/* The shipped BasicInstanced.330 and BasicNoTextureInstanced.330 vertex shaders read the
+	attribute; any other shader must declare a mat4 i_instanceModelMatrix of its own. */
+STATIC bool RendererInterface::CanDrawInstanced( const Material* material )
+{
+	const ShaderReflection& reflection = s_activeRendererInterface->m_activeShaderLoader->GetPipelineReflection( material->pipeline );
+	return SupportsInstancing() && ( reflection.instanceModelMatrixSlot != ShaderReflection::SLOT_None );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Draws the vertex data once per matrix. The matrices are streamed into one buffer and read by the
+	material's i_instanceModelMatrix attribute, a column per attribute slot, so the whole set is one
+	draw call. Without instancing support, or a shader that reads the attribute, each instance is
+	drawn on its own with the matrix in the model matrix uniform instead.
+	
+	Expects the material to have been applied already, apart from its model matrix. */
+STATIC void RendererInterface::RenderVertexDataInstanced( const VertexData* vertData, const Material* material, const Float4x4Matrix* modelMatrices, unsigned int numberOfInstances )
+{
+	static const unsigned int FLOATS_PER_MATRIX_COLUMN = 4;
+	static const unsigned int MATRIX_COLUMNS = 4;
 
-		shaderLoader->DisableAttributeVariableInShader( attributeVariable );
+	if( numberOfInstances == 0 )
+		return;
+
+	CachingShaderLoader* shaderLoader = s_activeRendererInterface->m_activeShaderLoader;
+	const ShaderReflection& reflection = shaderLoader->GetPipelineReflection( material->pipeline );
 
-		delete attributeVariable;
+	int firstColumnSlot = -1;
+	if( CanDrawInstanced( material ) )
+		firstColumnSlot = shaderLoader->GetAttributeVariableSlot( reflection.GetAttribute( reflection.instanceModelMatrixSlot ) );
+
+	BindVertexDataToShader( vertData, material->pipeline );
+
+	if( firstColumnSlot < 0 )
+	{
+		PushMatrix();
+		for( unsigned int i = 0; i < numberOfInstances; ++i )
+		{
+			SetTopOfStackToMatrix( modelMatrices[ i ] );
+			ApplyMaterialModelMatrix( material );
+			RenderVertexArray( vertData->shape, 0, vertData->numberOfVertices );
+		}
+		PopMatrix();
+
+		UnbindVertexDataFromShader( vertData, material->pipeline );
+		return;
 	}
 
-	//No need to unbind the buffer; the following vertexes should take care of that.
+	unsigned int& instanceBufferID = s_activeRendererInterface->m_instanceMatrixBufferID;
+	if( instanceBufferID == 0 )
+		GenerateBuffer( 1, &instanceBufferID );
+
+	BindBufferObject( ARRAY_BUFFER, instanceBufferID );
+	SendDataToBuffer( ARRAY_BUFFER, numberOfInstances * sizeof( Float4x4Matrix ), modelMatrices );
+	for( unsigned int column = 0; column < MATRIX_COLUMNS; ++column )
+	{
+		unsigned int columnSlot = firstColumnSlot + column;
+		shaderLoader->BindVertexArrayToAttributeSlot( columnSlot, FLOATS_PER_MATRIX_COLUMN, TYPE_FLOAT, false, sizeof( Float4x4Matrix ),
+			reinterpret_cast< void* >( column * FLOATS_PER_MATRIX_COLUMN * sizeof( float ) ) );
+		shaderLoader->EnableAttributeSlotInShader( columnSlot );
+		SetGenericArrayInstanceDivisor( columnSlot, 1 );
+	}
+
+	RenderVertexArrayInstanced( vertData->shape, 0, vertData->numberOfVertices, numberOfInstances );
+
+	//Divisors outlive the draw, so they're put back before anything else uses these slots
+	for( unsigned int column = 0; column < MATRIX_COLUMNS; ++column )
+	{
+		unsigned int columnSlot = firstColumnSlot + column;
+		SetGenericArrayInstanceDivisor( columnSlot, 0 );
+		shaderLoader->DisableAttributeSlotInShader( columnSlot );
+	}
+	UnbindVertexDataFromShader( vertData, material->pipeline );
 }
 #pragma endregion //Convenience Structures
+
+#pragma region State Cache
+//-----------------------------------------------------------------------------------------------
+STATIC void RendererInterface::EndFrame()
+{
+	StateCache& stateCache = s_activeRendererInterface->m_stateCache;
+	stateCache.lastFrameStatistics = stateCache.currentFrameStatistics;
+	stateCache.currentFrameStatistics = StateCacheStatistics();
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC void RendererInterface::ForgetCachedState()
+{
+	s_activeRendererInterface->m_stateCache.Forget();
+}
+
+//-----------------------------------------------------------------------------------------------
+void RendererInterface::StateCache::Forget()
+{
+	numberOfKnownFeatures = 0;
+	numberOfKnownBuffers = 0;
+	for( unsigned int i = 0; i < MAX_TEXTURE_UNITS; ++i )
+		boundTextureIDs[ i ] = UNKNOWN_ID;
+	activeTextureUnit = UNKNOWN_ID;
+	shaderPipeline = nullptr;
+	shaderPipelineIsKnown = false;
+	lineWidth = 0.f;
+	lineWidthIsKnown = false;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RendererInterface::StateCache::ForgetBuffer( unsigned int bufferID )
+{
+	for( unsigned int i = 0; i < numberOfKnownBuffers; ++i )
+	{
+		if( knownBuffers[ i ].bufferID == bufferID )
+			knownBuffers[ i ].bufferID = UNKNOWN_ID;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RendererInterface::StateCache::ForgetTexture( unsigned int textureID )
+{
+	for( unsigned int i = 0; i < MAX_TEXTURE_UNITS; ++i )
+	{
+		if( boundTextureIDs[ i ] == textureID )
+			boundTextureIDs[ i ] = UNKNOWN_ID;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+bool RendererInterface::StateCache::UpdateFeature( Feature feature, bool isEnabled )
+{
+	for( unsigned int i = 0; i < numberOfKnownFeatures; ++i )
+	{
+		if( knownFeatures[ i ].feature != feature )
+			continue;
+
+		bool callIsNeeded = ( knownFeatures[ i ].isEnabled != isEnabled );
+		knownFeatures[ i ].isEnabled = isEnabled;
+		return CountCall( callIsNeeded );
+	}
+
+	if( numberOfKnownFeatures < MAX_FEATURES )
+	{
+		knownFeatures[ numberOfKnownFeatures ].feature = feature;
+		knownFeatures[ numberOfKnownFeatures ].isEnabled = isEnabled;
+		++numberOfKnownFeatures;
+	}
+	return CountCall( true );
+}
+
+//-----------------------------------------------------------------------------------------------
+bool RendererInterface::StateCache::UpdateActiveTextureUnit( unsigned int textureUnitNumber )
+{
+	bool callIsNeeded = ( activeTextureUnit != textureUnitNumber );
+	activeTextureUnit = textureUnitNumber;
+	return CountCall( callIsNeeded );
+}
+
+//-----------------------------------------------------------------------------------------------
+bool RendererInterface::StateCache::UpdateBoundBuffer( BufferType bufferType, unsigned int bufferID )
+{
+	for( unsigned int i = 0; i < numberOfKnownBuffers; ++i )
+	{
+		if( knownBuffers[ i ].bufferType != bufferType )
+			continue;
+
+		bool callIsNeeded = ( knownBuffers[ i ].bufferID != bufferID );
+		knownBuffers[ i ].bufferID = bufferID;
+		return CountCall( callIsNeeded );
+	}
+
+	if( numberOfKnownBuffers < MAX_BUFFER_TYPES )
+	{
+		knownBuffers[ numberOfKnownBuffers ].bufferType = bufferType;
+		knownBuffers[ numberOfKnownBuffers ].bufferID = bufferID;
+		++numberOfKnownBuffers;
+	}
+	return CountCall( true );
+}
+
+//-----------------------------------------------------------------------------------------------
+//Only the most recent binding on each unit is remembered, whatever its texture type
+bool RendererInterface::StateCache::UpdateBoundTexture( Feature textureType, unsigned int textureID )
+{
+	if( activeTextureUnit >= MAX_TEXTURE_UNITS )
+		return CountCall( true );
+
+	bool callIsNeeded = ( boundTextureIDs[ activeTextureUnit ] != textureID ) || ( boundTextureTypes[ activeTextureUnit ] != textureType );
+	boundTextureIDs[ activeTextureUnit ] = textureID;
+	boundTextureTypes[ activeTextureUnit ] = textureType;
+	return CountCall( callIsNeeded );
+}
+
+//-----------------------------------------------------------------------------------------------
+bool RendererInterface::StateCache::UpdateLineWidth( float widthPixels )
+{
+	bool callIsNeeded = !lineWidthIsKnown || ( lineWidth != widthPixels );
+	lineWidth = widthPixels;
+	lineWidthIsKnown = true;
+	return CountCall( callIsNeeded );
+}
+
+//-----------------------------------------------------------------------------------------------
+bool RendererInterface::StateCache::UpdateShaderPipeline( const ShaderPipeline* pipeline )
+{
+	bool callIsNeeded = !shaderPipelineIsKnown || ( shaderPipeline != pipeline );
+	shaderPipeline = pipeline;
+	shaderPipelineIsKnown = true;
+	return CountCall( callIsNeeded );
+}
+
+//-----------------------------------------------------------------------------------------------
+bool RendererInterface::StateCache::CountCall( bool callIsNeeded )
+{
+	if( callIsNeeded )
+		++currentFrameStatistics.issuedCalls;
+	else
+		++currentFrameStatistics.filteredCalls;
+	return callIsNeeded;
+}
+#pragma endregion //State Cache
@@ -47,6 +47,12 @@ public:
 	static const DefaultAttributeName DEFAULT_NAME_Bitangent;
 	static const DefaultAttributeName DEFAULT_NAME_BoneIndex0;
 	static const DefaultAttributeName DEFAULT_NAME_BoneWeight0;
+	static const DefaultAttributeName DEFAULT_NAME_InstanceModelMatrix; //mat4, one per instance
+
+	typedef const char* DefaultUniformName;
+	static const DefaultUniformName DEFAULT_UNIFORM_ModelMatrix;
+	static const DefaultUniformName DEFAULT_UNIFORM_ViewMatrix;
+	static const DefaultUniformName DEFAULT_UNIFORM_ProjectionMatrix;
 
 	typedef unsigned short ArrayType;
 	static const ArrayType COLOR_ARRAYS;
@@ -153,6 +159,14 @@ public:
 	static void ApplyMaterial( const Material* material );
 	static void RemoveMaterial( const Material* material );
 
+	static void UseShaderPipeline( const ShaderPipeline* pipeline );
+
+	//Pieces of ApplyMaterial, for render loops that skip state the previous material already set
+	static void ApplyMaterialPipeline( const Material* material );
+	static void ApplyMaterialUniforms( const Material* material );
+	static void ApplyMaterialTextures( const Material* material );
+	static void ApplyMaterialModelMatrix( const Material* material );
+
 	//Bones
 	static void UpdateSkeletonOnMaterial( const Float4x4Matrix& objectStartingTransform, const std::vector< Bone >& skeleton, Material* material );
 
@@ -164,6 +178,22 @@ public:
 	static void BindVertexDataToShader( const VertexData* vertData, const ShaderPipeline* pipeline );
 	static void BufferVertexData( const VertexData* vertData );
 	static void UnbindVertexDataFromShader( const VertexData* vertData, const ShaderPipeline* pipeline );
+	static bool CanDrawInstanced( const Material* material );
+	static void RenderVertexDataInstanced( const VertexData* vertData, const Material* material, const Float4x4Matrix* modelMatrices, unsigned int numberOfInstances );
+
+
+
+	//State Cache
+	struct StateCacheStatistics
+	{
+		StateCacheStatistics() : issuedCalls( 0 ), filteredCalls( 0 ) { }
+
+		unsigned int issuedCalls;
+		unsigned int filteredCalls;
+	};
+	static void EndFrame();
+	static void ForgetCachedState(); //Call after anything outside this interface changes driver state
+	static const StateCacheStatistics& GetLastFrameStateCacheStatistics() { return s_activeRendererInterface->m_stateCache.lastFrameStatistics; }
 
 
 
@@ -223,6 +253,9 @@ public:
 	//Vertex/Index Arrays
 	static void RenderPartOfArray( Shape drawingShape, unsigned int numberPointsToDraw, CoordinateType indexType, const void* firstIndexToRender );
 	static void RenderVertexArray( Shape drawingShape, unsigned int startingArrayIndex, unsigned int numberPointsInArray );
+	static void RenderVertexArrayInstanced( Shape drawingShape, unsigned int startingArrayIndex, unsigned int numberPointsInArray, unsigned int numberOfInstances );
+	static void SetGenericArrayInstanceDivisor( unsigned int variableLocation, unsigned int instancesPerElement ); //0 advances per vertex
+	static bool SupportsInstancing();
 	static void SetPointerToColorArray( unsigned int coordinatesPerVertex, CoordinateType coordinateType, unsigned int gapBetweenVertices, const void* firstVertexInArray );
 	static void SetPointerToGenericArray( unsigned int variableLocation, int numberOfVertexCoordinates, CoordinateType coordinateType, bool normalizeData, unsigned int gapBetweenVertices, const void* firstVertexInArray );
 	static void SetPointerToTextureCoordinateArray( unsigned int coordinatesPerVertex, CoordinateType coordinateType, unsigned int gapBetweenVertices, const void* firstVertexInArray );
@@ -255,6 +288,8 @@ protected:
 
 	static const unsigned int MAX_BONES_IN_SHADER = 250;
 
+	unsigned int m_instanceMatrixBufferID; //Created the first time instances are drawn
+
 	RendererInterface();
 	virtual ~RendererInterface();
 
@@ -264,6 +299,67 @@ private:
 	static RendererInterface* s_activeRendererInterface;
 
 
+#pragma region State Cache
+	//-------------------------------------------------------------------------------------------
+	/* What the driver was last told, so the public interface can drop calls that wouldn't change
+		anything. Each Update function records the new value and returns false if the driver
+		already had it. Anything the cache has no room for, or doesn't know yet, is passed on. */
+	struct StateCache
+	{
+		static const unsigned int UNKNOWN_ID = 0xFFFFFFFF;
+		static const unsigned int MAX_FEATURES = 8;
+		static const unsigned int MAX_BUFFER_TYPES = 4;
+		static const unsigned int MAX_TEXTURE_UNITS = 8;
+
+		StateCache() { Forget(); }
+
+		void Forget();
+		void ForgetBuffer( unsigned int bufferID );
+		void ForgetTexture( unsigned int textureID );
+
+		bool UpdateFeature( Feature feature, bool isEnabled );
+		bool UpdateActiveTextureUnit( unsigned int textureUnitNumber );
+		bool UpdateBoundBuffer( BufferType bufferType, unsigned int bufferID );
+		bool UpdateBoundTexture( Feature textureType, unsigned int textureID );
+		bool UpdateLineWidth( float widthPixels );
+		bool UpdateShaderPipeline( const ShaderPipeline* pipeline );
+
+		bool CountCall( bool callIsNeeded );
+
+		//-------------------------------------------------------------------------------------------
+		struct KnownFeature
+		{
+			Feature feature;
+			bool isEnabled;
+		};
+
+		//-------------------------------------------------------------------------------------------
+		struct KnownBuffer
+		{
+			BufferType bufferType;
+			unsigned int bufferID;
+		};
+
+		//Data Members
+		KnownFeature knownFeatures[ MAX_FEATURES ];
+		unsigned int numberOfKnownFeatures;
+		KnownBuffer knownBuffers[ MAX_BUFFER_TYPES ];
+		unsigned int numberOfKnownBuffers;
+		Feature boundTextureTypes[ MAX_TEXTURE_UNITS ];
+		unsigned int boundTextureIDs[ MAX_TEXTURE_UNITS ];
+		unsigned int activeTextureUnit;
+		const ShaderPipeline* shaderPipeline;
+		bool shaderPipelineIsKnown;
+		float lineWidth;
+		bool lineWidthIsKnown;
+
+		StateCacheStatistics currentFrameStatistics;
+		StateCacheStatistics lastFrameStatistics;
+	};
+	StateCache m_stateCache;
+#pragma endregion //State Cache
+
+
 #pragma region Internal Interface Declarations
 	virtual void Initialize() = 0;
 
@@ -322,6 +418,9 @@ private:
 	//Vertex/Index Arrays
 	virtual void DoRenderPartOfArray( Shape drawingShape, unsigned int numberPointsToDraw, CoordinateType indexType, const void* firstIndexToRender ) const = 0;
 	virtual void DoRenderVertexArray( Shape drawingShape, unsigned int startingArrayIndex, unsigned int numberPointsInArray ) const = 0;
+	virtual void DoRenderVertexArrayInstanced( Shape drawingShape, unsigned int startingArrayIndex, unsigned int numberPointsInArray, unsigned int numberOfInstances ) const = 0;
+	virtual void DoSetGenericArrayInstanceDivisor( unsigned int variableLocation, unsigned int instancesPerElement ) const = 0;
+	virtual bool DoSupportsInstancing() const = 0;
 	virtual void DoSetPointerToColorArray( unsigned int coordinatesPerVertex, CoordinateType coordinateType, unsigned int gapBetweenVertices, const void* firstVertexInArray ) const = 0;
 	virtual void DoSetPointerToGenericArray( unsigned int variableLocation, int numberOfVertexCoordinates, CoordinateType coordinateType, bool normalizeData, unsigned int gapBetweenVertices, const void* firstVertexInArray ) const = 0;
 	virtual void DoSetPointerToTextureCoordinateArray( unsigned int coordinatesPerVertex, CoordinateType coordinateType, unsigned int gapBetweenVertices, const void* firstVertexInArray ) const = 0;
@@ -344,6 +443,7 @@ inline RendererInterface::RendererInterface()
 	, m_activeFontLoader( nullptr )
 	, m_activeShaderLoader( nullptr )
 	, m_activeTextureManager( nullptr )
+	, m_instanceMatrixBufferID( 0 )
 {
 	m_matrixStack.push( F4X4_IDENTITY_MATRIX );
 }
@@ -524,13 +624,15 @@ STATIC inline void RendererInterface::DisableArrayType( ArrayType type )
 //-----------------------------------------------------------------------------------------------
 STATIC inline void RendererInterface::EnableFeature( Feature feature )
 {
-	s_activeRendererInterface->DoEnableFeature( feature );
+	if( s_activeRendererInterface->m_stateCache.UpdateFeature( feature, true ) )
+		s_activeRendererInterface->DoEnableFeature( feature );
 }
 
 //-----------------------------------------------------------------------------------------------
 STATIC inline void RendererInterface::DisableFeature( Feature feature )
 {
-	s_activeRendererInterface->DoDisableFeature( feature );
+	if( s_activeRendererInterface->m_stateCache.UpdateFeature( feature, false ) )
+		s_activeRendererInterface->DoDisableFeature( feature );
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -656,7 +758,8 @@ STATIC inline void RendererInterface::SetColor( float red, float green, float bl
 //-----------------------------------------------------------------------------------------------
 STATIC inline void RendererInterface::SetLineWidth( float widthPixels )
 {
-	s_activeRendererInterface->DoSetLineWidth( widthPixels );
+	if( s_activeRendererInterface->m_stateCache.UpdateLineWidth( widthPixels ) )
+		s_activeRendererInterface->DoSetLineWidth( widthPixels );
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -686,7 +789,8 @@ STATIC inline void RendererInterface::SetMipmapQuality( QualityLevel qualityLeve
 //-----------------------------------------------------------------------------------------------
 STATIC inline void RendererInterface::BindTexture( Feature textureType, const Texture* texture )
 {
-	s_activeRendererInterface->DoBindTexture( textureType, texture );
+	if( s_activeRendererInterface->m_stateCache.UpdateBoundTexture( textureType, texture->textureIDOnCard ) )
+		s_activeRendererInterface->DoBindTexture( textureType, texture );
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -701,6 +805,7 @@ STATIC inline void RendererInterface::CreateTextureFrom2DImage( Feature textureT
 //-----------------------------------------------------------------------------------------------
 STATIC inline void RendererInterface::DeleteTextureDataOnCard( Texture* texture )
 {
+	s_activeRendererInterface->m_stateCache.ForgetTexture( texture->textureIDOnCard );
 	s_activeRendererInterface->DoDeleteTextureDataOnCard( texture );
 }
 
@@ -719,7 +824,8 @@ STATIC inline void RendererInterface::SetTextureInputImageAlignment( unsigned in
 //-----------------------------------------------------------------------------------------------
 STATIC inline void RendererInterface::SetActiveTextureUnit( unsigned int textureUnitNumber )
 {
-	s_activeRendererInterface->DoSetActiveTextureUnit( textureUnitNumber );
+	if( s_activeRendererInterface->m_stateCache.UpdateActiveTextureUnit( textureUnitNumber ) )
+		s_activeRendererInterface->DoSetActiveTextureUnit( textureUnitNumber );
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -752,6 +858,24 @@ STATIC inline void RendererInterface::RenderVertexArray( Shape drawingShape, uns
 	s_activeRendererInterface->DoRenderVertexArray( drawingShape, startingArrayIndex, numberPointsInArray );
 }
 
+//-----------------------------------------------------------------------------------------------
+STATIC inline void RendererInterface::RenderVertexArrayInstanced( Shape drawingShape, unsigned int startingArrayIndex, unsigned int numberPointsInArray, unsigned int numberOfInstances )
+{
+	s_activeRendererInterface->DoRenderVertexArrayInstanced( drawingShape, startingArrayIndex, numberPointsInArray, numberOfInstances );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC inline void RendererInterface::SetGenericArrayInstanceDivisor( unsigned int variableLocation, unsigned int instancesPerElement )
+{
+	s_activeRendererInterface->DoSetGenericArrayInstanceDivisor( variableLocation, instancesPerElement );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC inline bool RendererInterface::SupportsInstancing()
+{
+	return s_activeRendererInterface->DoSupportsInstancing();
+}
+
 //-----------------------------------------------------------------------------------------------
 STATIC inline void RendererInterface::SetPointerToColorArray( unsigned int coordinatesPerVertex, CoordinateType coordinateType, unsigned int gapBetweenVertices, const void* firstVertexInArray )
 {
@@ -788,12 +912,14 @@ STATIC inline void RendererInterface::SetShapeRestartIndex( unsigned int index )
 //-----------------------------------------------------------------------------------------------
 STATIC inline void RendererInterface::BindBufferObject( BufferType bufferType, unsigned int bufferID )
 {
-	s_activeRendererInterface->DoBindBufferObject( bufferType, bufferID );
+	if( s_activeRendererInterface->m_stateCache.UpdateBoundBuffer( bufferType, bufferID ) )
+		s_activeRendererInterface->DoBindBufferObject( bufferType, bufferID );
 }
 
 //-----------------------------------------------------------------------------------------------
 STATIC inline void RendererInterface::DeleteBufferObject( unsigned int bufferID )
 {
+	s_activeRendererInterface->m_stateCache.ForgetBuffer( bufferID );
 	s_activeRendererInterface->DoDeleteBufferObject( bufferID );
 }
 
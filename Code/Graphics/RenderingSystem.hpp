@@ -3,22 +3,25 @@
 #define INCLUDED_RENDERING_SYSTEM_HPP
 
 //-----------------------------------------------------------------------------------------------
-#include <vector>
-
+#include "../DeferredRemovalVector.hpp"
 #include "../System.hpp"
+#include "MeshComponent.hpp"
 
 struct CameraComponent;
-struct MeshComponent;
 
 //-----------------------------------------------------------------------------------------------
 ABSTRACT class RenderingSystem : public System
 {
 public:
-	RenderingSystem() : System(), m_activeCamera( nullptr ) { }
+	RenderingSystem() : System(), m_activeCamera( nullptr ), m_interpolationAlpha( 1.f ) { }
 
-	void AddMeshComponent( MeshComponent* mesh ) { m_meshes.push_back( mesh ); }
+	void AddMeshComponent( MeshComponent* mesh ) { m_meshes.AddElement( mesh ); }
+	void SetMeshComponentReleaser( const DeferredRemovalVector< MeshComponent >::ElementReleaser& releaser ) { m_meshes.SetElementReleaser( releaser ); }
 	void SetActiveCamera( CameraComponent* camera ) { m_activeCamera = camera; }
 
+	//How far between their previous and current positions entities are drawn (see TerrestrialPhysicsSystem::GetInterpolationAlpha)
+	void SetInterpolationAlpha( float interpolationAlpha ) { m_interpolationAlpha = interpolationAlpha; }
+
 	//Lifecycle
 	virtual void OnAttachment( SystemManager* manager ) = 0;
 	virtual void OnEndFrame() { }
@@ -27,8 +30,9 @@ public:
 	virtual void OnDestruction() = 0;
 
 	//Stored Components
-	std::vector< MeshComponent* > m_meshes;
+	DeferredRemovalVector< MeshComponent > m_meshes;
 	CameraComponent* m_activeCamera;
+	float m_interpolationAlpha;
 };
 
 #endif //INCLUDED_RENDERING_SYSTEM_HPP
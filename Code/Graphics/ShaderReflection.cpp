@@ -0,0 +1,80 @@
+#include "ShaderReflection.hpp"
+
+#include <algorithm>
+#include <string.h>
+#include <string>
+
+#include "RendererInterface.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+ShaderReflection::ShaderReflection()
+	: modelMatrixSlot( SLOT_None )
+	, viewMatrixSlot( SLOT_None )
+	, projectionMatrixSlot( SLOT_None )
+	, instanceModelMatrixSlot( SLOT_None )
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+/* GLSL reports a uniform array by its first element ("u_lights[0]"), so arrays are also
+	filed under their bare name for code that asks for the array itself. */
+void ShaderReflection::AddUniform( const char* uniformName, ShaderVariable* variable )
+{
+	ReflectedVariable uniform;
+	uniform.nameHash = HashStringLiteral( uniformName );
+	uniform.variable = variable;
+	uniforms.push_back( uniform );
+
+	static const char* const FIRST_ELEMENT_SUFFIX = "[0]";
+	static const size_t FIRST_ELEMENT_SUFFIX_LENGTH = 3;
+	size_t nameLength = strlen( uniformName );
+	if( nameLength > FIRST_ELEMENT_SUFFIX_LENGTH && strcmp( uniformName + nameLength - FIRST_ELEMENT_SUFFIX_LENGTH, FIRST_ELEMENT_SUFFIX ) == 0 )
+	{
+		std::string arrayName( uniformName, nameLength - FIRST_ELEMENT_SUFFIX_LENGTH );
+		uniform.nameHash = HashStringLiteral( arrayName.c_str() );
+		uniforms.push_back( uniform );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void ShaderReflection::AddAttribute( const char* attributeName, ShaderVariable* variable )
+{
+	ReflectedVariable attribute;
+	attribute.nameHash = HashStringLiteral( attributeName );
+	attribute.variable = variable;
+	attributes.push_back( attribute );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* A name added more than once (a uniform used by several stages, say) keeps its first variable. */
+void ShaderReflection::FinishBuilding()
+{
+	std::stable_sort( uniforms.begin(), uniforms.end() );
+	uniforms.erase( std::unique( uniforms.begin(), uniforms.end(), HaveSameName ), uniforms.end() );
+	std::stable_sort( attributes.begin(), attributes.end() );
+	attributes.erase( std::unique( attributes.begin(), attributes.end(), HaveSameName ), attributes.end() );
+
+	modelMatrixSlot = FindUniformSlot( HashStringLiteral( RendererInterface::DEFAULT_UNIFORM_ModelMatrix ) );
+	viewMatrixSlot = FindUniformSlot( HashStringLiteral( RendererInterface::DEFAULT_UNIFORM_ViewMatrix ) );
+	projectionMatrixSlot = FindUniformSlot( HashStringLiteral( RendererInterface::DEFAULT_UNIFORM_ProjectionMatrix ) );
+	instanceModelMatrixSlot = FindAttributeSlot( HashStringLiteral( RendererInterface::DEFAULT_NAME_InstanceModelMatrix ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC bool ShaderReflection::HaveSameName( const ReflectedVariable& first, const ReflectedVariable& second )
+{
+	return first.nameHash == second.nameHash;
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC ShaderReflection::Slot ShaderReflection::FindSlot( const std::vector< ReflectedVariable >& variables, HashedString::Hash nameHash )
+{
+	ReflectedVariable variableToFind;
+	variableToFind.nameHash = nameHash;
+
+	std::vector< ReflectedVariable >::const_iterator foundVariable = std::lower_bound( variables.begin(), variables.end(), variableToFind );
+	if( foundVariable == variables.end() || foundVariable->nameHash != nameHash )
+		return SLOT_None;
+	return static_cast< Slot >( foundVariable - variables.begin() );
+}
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef INCLUDED_SHADER_REFLECTION_HPP
+#define INCLUDED_SHADER_REFLECTION_HPP
+
+//-----------------------------------------------------------------------------------------------
+#include <vector>
+
+#include "../EngineMacros.hpp"
+#include "../HashedString.hpp"
+
+struct ShaderVariable;
+
+//-----------------------------------------------------------------------------------------------
+/* Every active uniform and attribute of one pipeline, looked up by the shader loader once when
+	the pipeline is linked. Variables are then addressed by slot (an index into these tables), so
+	applying a material or binding vertex data does integer work only. Finding a slot by name is
+	a binary search on the name's hash, which never allocates.
+
+	The loader that linked the pipeline owns the variables. A name the pipeline doesn't use has no
+	slot, and code binding by slot skips it rather than erroring. */
+struct ShaderReflection
+{
+	typedef int Slot;
+	static const Slot SLOT_None = -1;
+
+	//-------------------------------------------------------------------------------------------
+	struct ReflectedVariable
+	{
+		bool operator<( const ReflectedVariable& other ) const { return nameHash < other.nameHash; }
+
+		HashedString::Hash nameHash;
+		ShaderVariable* variable;
+	};
+
+	ShaderReflection();
+
+	//Building (by shader loaders, while linking)
+	void AddUniform( const char* uniformName, ShaderVariable* variable );
+	void AddAttribute( const char* attributeName, ShaderVariable* variable );
+	void FinishBuilding();
+
+	//Lookups
+	Slot FindUniformSlot( HashedString::Hash nameHash ) const { return FindSlot( uniforms, nameHash ); }
+	Slot FindAttributeSlot( HashedString::Hash nameHash ) const { return FindSlot( attributes, nameHash ); }
+	ShaderVariable* GetUniform( Slot slot ) const { return ( slot == SLOT_None ) ? nullptr : uniforms[ slot ].variable; }
+	ShaderVariable* GetAttribute( Slot slot ) const { return ( slot == SLOT_None ) ? nullptr : attributes[ slot ].variable; }
+
+	//Data Members
+	std::vector< ReflectedVariable > uniforms; //Sorted by name hash once built
+	std::vector< ReflectedVariable > attributes; //Sorted by name hash once built
+	Slot modelMatrixSlot;
+	Slot viewMatrixSlot;
+	Slot projectionMatrixSlot;
+	Slot instanceModelMatrixSlot; //An attribute slot; SLOT_None when the pipeline can't be instanced
+
+private:
+	static bool HaveSameName( const ReflectedVariable& first, const ReflectedVariable& second );
+	static Slot FindSlot( const std::vector< ReflectedVariable >& variables, HashedString::Hash nameHash );
+};
+
+#endif //INCLUDED_SHADER_REFLECTION_HPP
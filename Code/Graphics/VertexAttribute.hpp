@@ -3,6 +3,7 @@
 #define INCLUDED_VERTEX_ATTRIBUTE_HPP
 
 //-----------------------------------------------------------------------------------------------
+#include "../HashedString.hpp"
 #include "RendererInterface.hpp"
 
 //-----------------------------------------------------------------------------------------------
@@ -14,6 +15,7 @@ struct VertexAttribute
 
 	//Data Members
 	const char* shaderVariableName;
+	HashedString::Hash shaderVariableNameHash; //Looked up in the pipeline's ShaderReflection
 	unsigned int numberOfComponents;
 	RendererInterface::CoordinateType coordinateType;
 	bool normalizeFixedPointData;
@@ -27,6 +29,7 @@ struct VertexAttribute
 inline VertexAttribute::VertexAttribute( const char* variableName, unsigned int numComponents, RendererInterface::CoordinateType type, 
 										 bool normalizeFixedPtData, unsigned int bytesToNextInstance, size_t attributeStructureOffset )
 	: shaderVariableName( variableName )
+	, shaderVariableNameHash( HashStringLiteral( variableName ) )
 	, numberOfComponents( numComponents )
 	, coordinateType( type )
 	, normalizeFixedPointData( normalizeFixedPtData )
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "RendererInterface.hpp"
+#include "ShaderReflection.hpp"
 #include "VertexAttribute.hpp"
 
 
@@ -23,6 +24,7 @@ public:
 	void Append( const VertexData& other );
 	void Copy( const VertexData& other );
 	bool IsBuffered() const { return ( bufferID != NO_BUFFER ); }
+	const ShaderReflection::Slot* GetAttributeSlotsInPipeline( const ShaderPipeline* pipeline, const ShaderReflection& reflection ) const;
 
 
 	//Data Members
@@ -32,6 +34,10 @@ public:
 	unsigned int bufferID;
 	std::vector< VertexAttribute > attributes;
 	RendererInterface::Shape shape;
+
+	//Cached by GetAttributeSlotsInPipeline
+	mutable const ShaderPipeline* attributeSlotsPipeline;
+	mutable std::vector< ShaderReflection::Slot > attributeSlots;
 };
 
 
@@ -42,6 +48,7 @@ inline VertexData::VertexData()
 	, vertexSizeBytes( 0 )
 	, numberOfVertices( 0 )
 	, bufferID( NO_BUFFER )
+	, attributeSlotsPipeline( nullptr )
 { }
 
 //-----------------------------------------------------------------------------------------------
@@ -50,6 +57,7 @@ inline VertexData::VertexData( unsigned int numberOfVerts, size_t sizeOfVerts )
 	, vertexSizeBytes( sizeOfVerts )
 	, numberOfVertices( numberOfVerts )
 	, bufferID( NO_BUFFER )
+	, attributeSlotsPipeline( nullptr )
 { }
 
 //-----------------------------------------------------------------------------------------------
@@ -86,4 +94,23 @@ inline void VertexData::Copy( const VertexData& other )
 	memcpy( data, other.data, otherSize );
 }
 
+//-----------------------------------------------------------------------------------------------
+/* One slot per attribute, in order. They're only looked up again when the data is bound to a
+	different pipeline or its number of attributes changes, so a mesh drawn with the same material
+	every frame does no name lookups. */
+inline const ShaderReflection::Slot* VertexData::GetAttributeSlotsInPipeline( const ShaderPipeline* pipeline, const ShaderReflection& reflection ) const
+{
+	if( pipeline != attributeSlotsPipeline || attributeSlots.size() != attributes.size() )
+	{
+		attributeSlotsPipeline = pipeline;
+		attributeSlots.resize( attributes.size() );
+		for( unsigned int i = 0; i < attributes.size(); ++i )
+			attributeSlots[ i ] = reflection.FindAttributeSlot( attributes[ i ].shaderVariableNameHash );
+	}
+
+	if( attributeSlots.empty() )
+		return nullptr;
+	return &attributeSlots[ 0 ];
+}
+
 #endif //INCLUDED_VERTEX_DATA_HPP
@@ -1,5 +1,155 @@
 #include "HashFunctions.hpp"
 
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "DebuggerInterface.hpp"
+#include "EngineMacros.hpp"
+#include "TimeInterface.hpp"
+
+//-----------------------------------------------------------------------------------------------
+struct NamedStringHashFunction
+{
+	const char* name;
+	Hash ( *hashString )( const char* string );
+	Hash ( *hashBuffer )( const unsigned char* buffer, unsigned int bufferSize );
+};
+
+static Hash HashStringWithXX64LowBits( const char* string ) { return static_cast< Hash >( HashWithXX64( string ) ); }
+static Hash HashBufferWithXX64LowBits( const unsigned char* buffer, unsigned int bufferSize ) { return static_cast< Hash >( HashWithXX64( buffer, bufferSize ) ); }
+
+static const NamedStringHashFunction HASH_FUNCTIONS_UNDER_TEST[] =
+{
+	{ "DJB2",		&HashWithDJB2,				&HashWithDJB2 },
+	{ "SDBM",		&HashWithSDBM,				&HashWithSDBM },
+	{ "Eiserloh",	&HashWithEiserloh,			&HashWithEiserloh },
+	{ "Hsieh",		&HashWithHsieh,				&HashWithHsieh },
+	{ "XX64",		&HashStringWithXX64LowBits,	&HashBufferWithXX64LowBits }
+};
+static const unsigned int NUMBER_OF_HASH_FUNCTIONS_UNDER_TEST = sizeof( HASH_FUNCTIONS_UNDER_TEST ) / sizeof( HASH_FUNCTIONS_UNDER_TEST[ 0 ] );
+
+//-----------------------------------------------------------------------------------------------
+/* Keys shaped like the engine's real ones: long paths that differ in a few digits near the
+	end, and short dotted event names. */
+static void GenerateTestKeys( unsigned int numberOfKeys, std::vector< std::string >& out_assetPaths, std::vector< std::string >& out_eventNames )
+{
+	static const char* const ASSET_TYPES[] = { "Textures", "Meshes", "Sounds", "Shaders" };
+	static const char* const EVENT_VERBS[] = { "Damaged", "Healed", "Spawned", "Destroyed", "Collided", "Selected" };
+
+	char keyBuffer[ 128 ];
+	for( unsigned int i = 0; i < numberOfKeys; ++i )
+	{
+		sprintf( keyBuffer, "Data/%s/Level%02u/Props/Prop_%05u_Diffuse.png", ASSET_TYPES[ i % 4 ], ( i / 4 ) % 100, i );
+		out_assetPaths.push_back( keyBuffer );
+
+		sprintf( keyBuffer, "Gameplay.Entity%u.On%s", i / 6, EVENT_VERBS[ i % 6 ] );
+		out_eventNames.push_back( keyBuffer );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Full collisions are keys sharing an entire 32-bit hash. Chains come from filing the hashes in a
+	power-of-two table (at least as many buckets as keys) by their low bits, as most tables do; the
+	average chain is the length a successful lookup walks, which is ~1.4 for an ideal hash here. */
+static void ReportHashQuality( const char* keySetName, const std::vector< std::string >& keys )
+{
+	unsigned int numberOfBuckets = 1;
+	while( numberOfBuckets < keys.size() )
+		numberOfBuckets *= 2;
+
+	std::vector< Hash > hashes( keys.size() );
+	std::vector< unsigned int > bucketLoads( numberOfBuckets );
+	for( unsigned int functionIndex = 0; functionIndex < NUMBER_OF_HASH_FUNCTIONS_UNDER_TEST; ++functionIndex )
+	{
+		const NamedStringHashFunction& hashFunction = HASH_FUNCTIONS_UNDER_TEST[ functionIndex ];
+		std::fill( bucketLoads.begin(), bucketLoads.end(), 0 );
+
+		for( unsigned int i = 0; i < keys.size(); ++i )
+		{
+			hashes[ i ] = hashFunction.hashString( keys[ i ].c_str() );
+			++bucketLoads[ hashes[ i ] & ( numberOfBuckets - 1 ) ];
+		}
+
+		std::sort( hashes.begin(), hashes.end() );
+		unsigned int numberOfFullCollisions = 0;
+		for( unsigned int i = 1; i < hashes.size(); ++i )
+		{
+			if( hashes[ i ] == hashes[ i - 1 ] )
+				++numberOfFullCollisions;
+		}
+
+		unsigned int longestChain = 0;
+		double totalLookupSteps = 0.0;
+		for( unsigned int i = 0; i < numberOfBuckets; ++i )
+		{
+			longestChain = std::max( longestChain, bucketLoads[ i ] );
+			totalLookupSteps += 0.5 * bucketLoads[ i ] * ( bucketLoads[ i ] + 1 );
+		}
+
+		PrintfToDebuggerOutput( "  %-10s %-8s full collisions %6u, longest chain %5u, average chain %.2f\n", keySetName, hashFunction.name,
+			numberOfFullCollisions, longestChain, totalLookupSteps / keys.size() );
+	}
+}
+
+
+
+//-----------------------------------------------------------------------------------------------
+void BenchmarkHashFunctions()
+{
+	static const unsigned int NUMBER_OF_NAMES = 10000;
+	static const unsigned int PASSES_OVER_NAMES = 100;
+	static const unsigned int LARGE_BUFFER_BYTES = 16 * 1024 * 1024;
+
+	std::vector< std::string > assetPaths;
+	std::vector< std::string > eventNames;
+	GenerateTestKeys( NUMBER_OF_NAMES, assetPaths, eventNames );
+
+	std::vector< unsigned char > largeBuffer( LARGE_BUFFER_BYTES );
+	for( unsigned int i = 0; i < LARGE_BUFFER_BYTES; ++i )
+		largeBuffer[ i ] = static_cast< unsigned char >( i * 2654435761u >> 24 );
+
+	Hash checksum = 0;
+	PrintfToDebuggerOutput( "Hash function benchmark:\n" );
+	for( unsigned int functionIndex = 0; functionIndex < NUMBER_OF_HASH_FUNCTIONS_UNDER_TEST; ++functionIndex )
+	{
+		const NamedStringHashFunction& hashFunction = HASH_FUNCTIONS_UNDER_TEST[ functionIndex ];
+
+		double startTimeSeconds = GetCurrentTimeSeconds();
+		for( unsigned int pass = 0; pass < PASSES_OVER_NAMES; ++pass )
+		{
+			for( unsigned int i = 0; i < NUMBER_OF_NAMES; ++i )
+				checksum += hashFunction.hashString( eventNames[ i ].c_str() );
+		}
+		double nameSeconds = GetCurrentTimeSeconds() - startTimeSeconds;
+
+		startTimeSeconds = GetCurrentTimeSeconds();
+		checksum += hashFunction.hashBuffer( &largeBuffer[ 0 ], LARGE_BUFFER_BYTES );
+		double bufferSeconds = GetCurrentTimeSeconds() - startTimeSeconds;
+
+		PrintfToDebuggerOutput( "  %-8s event names %.1f ns each, %u MB buffer %.0f MB/s\n", hashFunction.name,
+			nameSeconds * 1.0e9 / ( NUMBER_OF_NAMES * PASSES_OVER_NAMES ), LARGE_BUFFER_BYTES / ( 1024 * 1024 ),
+			( LARGE_BUFFER_BYTES / ( 1024.0 * 1024.0 ) ) / bufferSeconds );
+	}
+	PrintfToDebuggerOutput( "  (checksum %u)\n", checksum );
+}
+
+//-----------------------------------------------------------------------------------------------
+void TestHashFunctionQuality( unsigned int numberOfKeys )
+{
+	std::vector< std::string > assetPaths;
+	std::vector< std::string > eventNames;
+	GenerateTestKeys( numberOfKeys, assetPaths, eventNames );
+
+	PrintfToDebuggerOutput( "Hash function quality over %u keys per set:\n", numberOfKeys );
+	ReportHashQuality( "assets", assetPaths );
+	ReportHashQuality( "events", eventNames );
+}
+
+
+
 #pragma region DJB2
 //-----------------------------------------------------------------------------------------------
 Hash HashWithDJB2( const char* string )
@@ -67,17 +217,66 @@ Hash HashWithEiserloh( const unsigned char* buffer, unsigned int bufferSize )
 
 
 #pragma region Hsieh
-// This function currently unimplemented (link to eventual implementation is in header)
 //-----------------------------------------------------------------------------------------------
-Hash HashWithHsieh( const char* /*string*/ )
+static inline Hash GetLittleEndian16Bits( const unsigned char* bytes )
 {
-	return 0;
+	return ( static_cast< Hash >( bytes[ 1 ] ) << 8 ) + static_cast< Hash >( bytes[ 0 ] );
 }
 
 //-----------------------------------------------------------------------------------------------
-Hash HashWithHsieh( const unsigned char* /*buffer*/, unsigned int /*bufferSize*/ )
+Hash HashWithHsieh( const char* string )
 {
-	return 0;
+	return HashWithHsieh( reinterpret_cast< const unsigned char* >( string ), static_cast< unsigned int >( strlen( string ) ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* SuperFastHash: four bytes per step, taken as two 16-bit halves, then an avalanche so the
+	high and low bits are both usable as table indices. */
+Hash HashWithHsieh( const unsigned char* buffer, unsigned int bufferSize )
+{
+	if( buffer == nullptr || bufferSize == 0 )
+		return 0;
+
+	Hash hash = bufferSize;
+	Hash temporary;
+	unsigned int remainingBytes = bufferSize & 3;
+
+	for( unsigned int numberOfSteps = bufferSize >> 2; numberOfSteps > 0; --numberOfSteps )
+	{
+		hash += GetLittleEndian16Bits( buffer );
+		temporary = ( GetLittleEndian16Bits( buffer + 2 ) << 11 ) ^ hash;
+		hash = ( hash << 16 ) ^ temporary;
+		buffer += 4;
+		hash += hash >> 11;
+	}
+
+	switch( remainingBytes )
+	{
+	case 3:
+		hash += GetLittleEndian16Bits( buffer );
+		hash ^= hash << 16;
+		hash ^= static_cast< Hash >( static_cast< signed char >( buffer[ 2 ] ) ) << 18;
+		hash += hash >> 11;
+		break;
+	case 2:
+		hash += GetLittleEndian16Bits( buffer );
+		hash ^= hash << 11;
+		hash += hash >> 17;
+		break;
+	case 1:
+		hash += static_cast< Hash >( static_cast< signed char >( buffer[ 0 ] ) );
+		hash ^= hash << 10;
+		hash += hash >> 1;
+		break;
+	}
+
+	hash ^= hash << 3;
+	hash += hash >> 5;
+	hash ^= hash << 4;
+	hash += hash >> 17;
+	hash ^= hash << 25;
+	hash += hash >> 6;
+	return hash;
 }
 #pragma endregion
 
@@ -113,3 +312,127 @@ Hash HashWithSDBM( const unsigned char* buffer, unsigned int bufferSize )
 	return hash;
 }
 #pragma endregion
+
+
+
+#pragma region XX64
+//-----------------------------------------------------------------------------------------------
+static const Hash64 XX64_PRIME_1 = 0x9E3779B185EBCA87ULL;
+static const Hash64 XX64_PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+static const Hash64 XX64_PRIME_3 = 0x165667B19E3779F9ULL;
+static const Hash64 XX64_PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+static const Hash64 XX64_PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+//-----------------------------------------------------------------------------------------------
+static inline Hash64 RotateLeft64( Hash64 value, unsigned int numberOfBits )
+{
+	return ( value << numberOfBits ) | ( value >> ( 64 - numberOfBits ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* xxHash is defined on little-endian words, so big-endian platforms swap to get the same hashes. */
+static inline Hash64 ReadLittleEndian64Bits( const unsigned char* bytes )
+{
+	Hash64 word;
+	memcpy( &word, bytes, sizeof( word ) );
+#if defined( PLATFORM_PS3 )
+	word = ( ( word & 0x00000000000000FFULL ) << 56 ) | ( ( word & 0x000000000000FF00ULL ) << 40 ) |
+		   ( ( word & 0x0000000000FF0000ULL ) << 24 ) | ( ( word & 0x00000000FF000000ULL ) << 8 ) |
+		   ( ( word & 0x000000FF00000000ULL ) >> 8 ) | ( ( word & 0x0000FF0000000000ULL ) >> 24 ) |
+		   ( ( word & 0x00FF000000000000ULL ) >> 40 ) | ( ( word & 0xFF00000000000000ULL ) >> 56 );
+#endif
+	return word;
+}
+
+//-----------------------------------------------------------------------------------------------
+static inline Hash64 ReadLittleEndian32Bits( const unsigned char* bytes )
+{
+	return static_cast< Hash64 >( bytes[ 0 ] ) | ( static_cast< Hash64 >( bytes[ 1 ] ) << 8 ) |
+		( static_cast< Hash64 >( bytes[ 2 ] ) << 16 ) | ( static_cast< Hash64 >( bytes[ 3 ] ) << 24 );
+}
+
+//-----------------------------------------------------------------------------------------------
+static inline Hash64 MixXX64Lane( Hash64 lane, Hash64 word )
+{
+	lane += word * XX64_PRIME_2;
+	lane = RotateLeft64( lane, 31 );
+	return lane * XX64_PRIME_1;
+}
+
+//-----------------------------------------------------------------------------------------------
+static inline Hash64 MergeXX64Lane( Hash64 hash, Hash64 lane )
+{
+	hash ^= MixXX64Lane( 0, lane );
+	return hash * XX64_PRIME_1 + XX64_PRIME_4;
+}
+
+//-----------------------------------------------------------------------------------------------
+Hash64 HashWithXX64( const char* string )
+{
+	return HashWithXX64( reinterpret_cast< const unsigned char* >( string ), static_cast< unsigned int >( strlen( string ) ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Buffers of 32 bytes or more are consumed in 32-byte stripes by four independent lanes, so
+	the multiplies of one step don't wait on each other and the compiler is free to vectorize.
+	The tail is taken eight, then four, then one byte at a time. */
+Hash64 HashWithXX64( const unsigned char* buffer, unsigned int bufferSize, Hash64 seed )
+{
+	const unsigned char* bufferEnd = buffer + bufferSize;
+	Hash64 hash;
+
+	if( bufferSize >= 32 )
+	{
+		const unsigned char* lastStripeStart = bufferEnd - 32;
+		Hash64 lane1 = seed + XX64_PRIME_1 + XX64_PRIME_2;
+		Hash64 lane2 = seed + XX64_PRIME_2;
+		Hash64 lane3 = seed;
+		Hash64 lane4 = seed - XX64_PRIME_1;
+
+		do
+		{
+			lane1 = MixXX64Lane( lane1, ReadLittleEndian64Bits( buffer ) );
+			lane2 = MixXX64Lane( lane2, ReadLittleEndian64Bits( buffer + 8 ) );
+			lane3 = MixXX64Lane( lane3, ReadLittleEndian64Bits( buffer + 16 ) );
+			lane4 = MixXX64Lane( lane4, ReadLittleEndian64Bits( buffer + 24 ) );
+			buffer += 32;
+		} while( buffer <= lastStripeStart );
+
+		hash = RotateLeft64( lane1, 1 ) + RotateLeft64( lane2, 7 ) + RotateLeft64( lane3, 12 ) + RotateLeft64( lane4, 18 );
+		hash = MergeXX64Lane( hash, lane1 );
+		hash = MergeXX64Lane( hash, lane2 );
+		hash = MergeXX64Lane( hash, lane3 );
+		hash = MergeXX64Lane( hash, lane4 );
+	}
+	else
+		hash = seed + XX64_PRIME_5;
+
+	hash += bufferSize;
+
+	for( ; buffer + 8 <= bufferEnd; buffer += 8 )
+	{
+		hash ^= MixXX64Lane( 0, ReadLittleEndian64Bits( buffer ) );
+		hash = RotateLeft64( hash, 27 ) * XX64_PRIME_1 + XX64_PRIME_4;
+	}
+
+	if( buffer + 4 <= bufferEnd )
+	{
+		hash ^= ReadLittleEndian32Bits( buffer ) * XX64_PRIME_1;
+		hash = RotateLeft64( hash, 23 ) * XX64_PRIME_2 + XX64_PRIME_3;
+		buffer += 4;
+	}
+
+	for( ; buffer < bufferEnd; ++buffer )
+	{
+		hash ^= static_cast< Hash64 >( *buffer ) * XX64_PRIME_5;
+		hash = RotateLeft64( hash, 11 ) * XX64_PRIME_1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= XX64_PRIME_2;
+	hash ^= hash >> 29;
+	hash *= XX64_PRIME_3;
+	hash ^= hash >> 32;
+	return hash;
+}
+#pragma endregion
@@ -7,10 +7,20 @@
 //	(DJB2 and sdbm) http://www.cse.yorku.ca/~oz/hash.html
 //	(Eiserloh)		Given from Squirrel Eiserloh directly in Spring 2014
 //	(Hsieh)			http://www.azillionmonkeys.com/qed/hash.html
+//	(XX64)			xxHash64 by Yann Collet, https://github.com/Cyan4973/xxHash
 //-----------------------------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------------------------
 typedef unsigned int Hash;
+typedef unsigned long long Hash64;
+
+//-----------------------------------------------------------------------------------------------
+//Benchmark of every hash function's throughput on short names and on a large buffer
+void BenchmarkHashFunctions();
+
+//-----------------------------------------------------------------------------------------------
+//Counts each hash function's full collisions and worst hash-table chain on asset paths and event names
+void TestHashFunctionQuality( unsigned int numberOfKeys = 100000 );
 
 
 // DJB2
@@ -35,4 +45,10 @@ Hash HashWithHsieh( const unsigned char* buffer, unsigned int bufferSize );
 Hash HashWithSDBM( const char* string );
 Hash HashWithSDBM( const unsigned char* buffer, unsigned int bufferSize );
 
+
+
+// XX64
+Hash64 HashWithXX64( const char* string );
+Hash64 HashWithXX64( const unsigned char* buffer, unsigned int bufferSize, Hash64 seed = 0 );
+
 #endif //INCLUDED_HASH_FUNCTIONS_HPP
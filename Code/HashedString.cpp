@@ -1,68 +1,112 @@
 #include "HashedString.hpp"
 
+#include <map>
+#if !defined( PLATFORM_SINGLE_THREADED )
+	#include <mutex>
+#endif
+
+#include "AssertionError.hpp"
 #include "HashFunctions.hpp"
 
+//-----------------------------------------------------------------------------------------------
+//Strings whose hashes collide share a key, so each hash can have more than one string
+typedef std::multimap< HashedString::Hash, std::string > InternTable;
+
+//-----------------------------------------------------------------------------------------------
+/* Function-local, so names constructed during static initialization can still intern. Map
+	nodes never move, so pointers to the strings stay valid for the life of the program. */
+static InternTable& GetInternTable()
+{
+	static InternTable s_internTable;
+	return s_internTable;
+}
+
+#if !defined( PLATFORM_SINGLE_THREADED )
+//-----------------------------------------------------------------------------------------------
+static std::mutex& GetInternTableMutex()
+{
+	static std::mutex s_internTableMutex;
+	return s_internTableMutex;
+}
+#endif
+
 
 
 #pragma region Construction
 //-----------------------------------------------------------------------------------------------
 HashedString::HashedString()
 	: m_hash( 0 )
-	, m_string( "" )
+	, m_string( nullptr )
 {
+	static const std::string s_emptyString;
+	m_string = &s_emptyString;
 }
 
 //-----------------------------------------------------------------------------------------------
 HashedString::HashedString( const std::string& string )
-	: m_hash( 0 )
-	, m_string( string )
+	: m_hash( HashWithDJB2( string.c_str() ) )
+	, m_string( nullptr )
 {
-	m_hash = HashWithDJB2( m_string.c_str() );
+	m_string = InternString( m_hash, string.c_str() );
 }
 
 //-----------------------------------------------------------------------------------------------
 HashedString::HashedString( const char* cString )
-	: m_hash( 0 )
-	, m_string( cString )
+	: m_hash( HashStringLiteral( cString ) )
+	, m_string( nullptr )
 {
-	m_hash = HashWithDJB2( cString );
+	m_string = InternString( m_hash, cString );
 }
 #pragma endregion
 
 
 
-#pragma region Operators
+#pragma region Intern Table
 //-----------------------------------------------------------------------------------------------
-bool HashedString::operator==(const HashedString& rhs) const
+STATIC size_t HashedString::GetNumberOfInternedStrings()
 {
-	if( this->m_hash == rhs.m_hash )
-	{
-		#ifdef CHECK_FOR_HASH_COLLISIONS
-		if( this->m_string.compare( rhs.m_string ) != 0 )
-		{
-			RECOVERABLE_ERROR( "String Hashing Error", "A hash collision was found in HashedString." );
-			return false;
-		}
-		#endif
-
-		return true;
-	}
-	return false;
+#if !defined( PLATFORM_SINGLE_THREADED )
+	std::lock_guard< std::mutex > internTableLock( GetInternTableMutex() );
+#endif
+	return GetInternTable().size();
 }
 
 //-----------------------------------------------------------------------------------------------
-bool HashedString::operator!=(const HashedString& rhs) const
+/* A string that's already in the table gets the copy that's there. Strings with colliding hashes
+	are each kept, so GetString always gives back the text the name was made from, even though
+	the names themselves compare equal. */
+STATIC const std::string* HashedString::InternString( Hash hash, const char* cString )
 {
-	return !( *this == rhs );
-}
+#if !defined( PLATFORM_SINGLE_THREADED )
+	std::lock_guard< std::mutex > internTableLock( GetInternTableMutex() );
+#endif
+	InternTable& internTable = GetInternTable();
 
-//-----------------------------------------------------------------------------------------------
-bool HashedString::operator<(const HashedString& rhs) const
-{
-	if( this->m_hash < rhs.m_hash )
+	std::pair< InternTable::iterator, InternTable::iterator > stringsWithHash = internTable.equal_range( hash );
+	for( InternTable::iterator internedString = stringsWithHash.first; internedString != stringsWithHash.second; ++internedString )
 	{
-		return true;
+		if( internedString->second.compare( cString ) == 0 )
+			return &internedString->second;
 	}
-	return false;
+
+	#ifdef CHECK_FOR_HASH_COLLISIONS
+	if( stringsWithHash.first != stringsWithHash.second )
+		RECOVERABLE_ERROR( "String Hashing Error", "A hash collision was found in HashedString." );
+	#endif
+
+	InternTable::iterator internedString = internTable.insert( stringsWithHash.second, InternTable::value_type( hash, cString ) );
+	return &internedString->second;
 }
 #pragma endregion
+
+
+
+#pragma region HashedStringView
+//-----------------------------------------------------------------------------------------------
+HashedStringView::HashedStringView( const std::string& string )
+	: m_hash( HashWithDJB2( string.c_str() ) )
+#if defined( ENABLE_ASSERTIONS )
+	, m_debugText( string.c_str() )
+#endif
+{ }
+#pragma endregion
@@ -5,28 +5,107 @@
 //-----------------------------------------------------------------------------------------------
 #include <string>
 
+#include "EngineMacros.hpp"
+
+//-----------------------------------------------------------------------------------------------
+/* Compilers without constexpr (VS2010) still get the literal hash inline, where the optimizer
+	can usually fold it. */
+#if defined( COMPILER_MICROSOFT_C ) && ( COMPILER_MICROSOFT_C_VERSION < 1900 )
+	#define HASHED_STRING_CONSTEXPR inline
+#else
+	#define HASHED_STRING_CONSTEXPR constexpr
+#endif
+
+//-----------------------------------------------------------------------------------------------
+//Same result as HashWithDJB2, but written so a string literal can be hashed at compile time
+HASHED_STRING_CONSTEXPR unsigned int HashStringLiteral( const char* cString, unsigned int hashSoFar = 5381 )
+{
+	return ( *cString == '\0' ) ? hashSoFar : HashStringLiteral( cString + 1, ( hashSoFar * 33 ) + *cString );
+}
+
+
+
 //-----------------------------------------------------------------------------------------------
+/* A name that keeps its text, for names that are shown or logged, such as actions. The text of
+	every HashedString is interned in one global table, so each distinct string is stored once and
+	copying a name never allocates. Constructing one takes a lock and a table lookup, and the table
+	is never emptied, so names built at runtime from unbounded data, and names in per-frame code,
+	should be HashedStringViews instead. Names compare by hash alone; hash collisions are reported
+	when the second string is interned (with CHECK_FOR_HASH_COLLISIONS defined). Interning is safe
+	from any thread. */
 class HashedString
 {
+public:
 	typedef unsigned int Hash;
 
-public:
 	//Construction
 	HashedString();
 	HashedString( const std::string& string );
 	HashedString( const char* cString );
 
 	//Getters
-	const std::string& GetString() const { return m_string; }
+	const std::string& GetString() const { return *m_string; }
+	Hash GetHash() const { return m_hash; }
 
 	//Operators
-	bool operator==(const HashedString& rhs) const;
-	bool operator!=(const HashedString& rhs) const;
-	bool operator<(const HashedString& rhs) const;
+	bool operator==(const HashedString& rhs) const { return m_hash == rhs.m_hash; }
+	bool operator!=(const HashedString& rhs) const { return m_hash != rhs.m_hash; }
+	bool operator<(const HashedString& rhs) const { return m_hash < rhs.m_hash; }
 	operator int() const { return m_hash; }
 
+	//Intern Table
+	static size_t GetNumberOfInternedStrings();
+
+private:
+	static const std::string* InternString( Hash hash, const char* cString );
+
+	Hash m_hash;
+	const std::string* m_string; //Owned by the intern table
+};
+
+
+
+//-----------------------------------------------------------------------------------------------
+/* Only the hash of a name, for hot paths that never need the text back, such as event dispatch
+	and NamedDataBundle parameters. Constructing one from a literal is free on compilers with
+	constexpr, and it never touches the intern table. Builds with assertions also keep a pointer to
+	the text for the debugger and error messages, so views built from temporary char buffers or
+	std::strings must not be inspected after the buffer is gone. */
+class HashedStringView
+{
+public:
+	typedef HashedString::Hash Hash;
+
+	//Construction
+#if defined( ENABLE_ASSERTIONS )
+	HashedStringView() : m_hash( 0 ), m_debugText( "" ) { }
+	HASHED_STRING_CONSTEXPR HashedStringView( const char* cString ) : m_hash( HashStringLiteral( cString ) ), m_debugText( cString ) { }
+	HashedStringView( const HashedString& hashedString ) : m_hash( hashedString.GetHash() ), m_debugText( hashedString.GetString().c_str() ) { }
+	HashedStringView( const std::string& string );
+#else
+	HASHED_STRING_CONSTEXPR HashedStringView() : m_hash( 0 ) { }
+	HASHED_STRING_CONSTEXPR HashedStringView( const char* cString ) : m_hash( HashStringLiteral( cString ) ) { }
+	HashedStringView( const HashedString& hashedString ) : m_hash( hashedString.GetHash() ) { }
+	HashedStringView( const std::string& string );
+#endif
+
+	//Getters
+	HASHED_STRING_CONSTEXPR Hash GetHash() const { return m_hash; }
+#if defined( ENABLE_ASSERTIONS )
+	const char* GetDebugText() const { return m_debugText; }
+#else
+	const char* GetDebugText() const { return "(name text not kept)"; }
+#endif
+
+	//Operators
+	bool operator==( const HashedStringView& rhs ) const { return m_hash == rhs.m_hash; }
+	bool operator!=( const HashedStringView& rhs ) const { return m_hash != rhs.m_hash; }
+	bool operator<( const HashedStringView& rhs ) const { return m_hash < rhs.m_hash; }
+
 private:
 	Hash m_hash;
-	std::string m_string;
+#if defined( ENABLE_ASSERTIONS )
+	const char* m_debugText;
+#endif
 };
 #endif //INCLUDED_HASHED_STRING_HPP
@@ -16,11 +16,7 @@ VIRTUAL InputSystem::~InputSystem()
 	}
 	m_controllers.clear();
 
-	for( unsigned int i = 0; i < m_inputs.size(); ++i )
-	{
-		delete m_inputs[ i ];
-	}
-	m_inputs.clear();
+	m_inputs.ReleaseAllElements();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -37,7 +33,7 @@ void InputSystem::OnUpdate( float )
 		m_controllers[ i ]->UpdatePossessedEntity( 0.0166f );
 	}
 
-	for( unsigned int i = 0; i < m_inputs.size(); ++i )
+	for( unsigned int i = 0; i < m_inputs.GetNumberOfElements(); ++i )
 	{
 		//fill the entity with our set of inputs
 		//m_inputs[ i ]->owner->eventParameters->SetParameter( "actionsQueued", m_inputs[ i ]->m_queuedActions );
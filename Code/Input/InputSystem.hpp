@@ -4,10 +4,11 @@
 
 //-----------------------------------------------------------------------------------------------
 #include <vector>
+#include "../DeferredRemovalVector.hpp"
 #include "../System.hpp"
+#include "InputComponent.hpp"
 
 class Controller;
-struct InputComponent;
 
 //-----------------------------------------------------------------------------------------------
 class InputSystem : public System
@@ -19,7 +20,7 @@ public:
 
 	virtual ~InputSystem();
 
-	void AddComponent( InputComponent* inputComponent ) { m_inputs.push_back( inputComponent ); }
+	void AddComponent( InputComponent* inputComponent ) { m_inputs.AddElement( inputComponent ); }
 	void AddController( Controller* controller ) { m_controllers.push_back( controller ); }
 
 	static void AddNewComponent( InputComponent* inputComponent ) { s_activeInputSystem->AddComponent( inputComponent ); }
@@ -31,7 +32,7 @@ public:
 
 protected: //For use only by SystemManager
 	virtual void OnAttachment( SystemManager* manager );
-	virtual void OnEndFrame() { }
+	virtual void OnEndFrame() { m_inputs.RemoveElementsReadyForDeletion(); }
 	virtual void OnRender() const { }
 	virtual void OnUpdate(  float deltaSeconds );
 	virtual void OnDestruction();
@@ -41,7 +42,7 @@ protected: //For use only by SystemManager
 	static InputSystem* s_activeInputSystem;
 
 	std::vector< Controller* > m_controllers;
-	std::vector< InputComponent* > m_inputs;
+	DeferredRemovalVector< InputComponent > m_inputs;
 };
 
 #endif //INCLUDED_INPUT_SYSTEM_HPP
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include "JobSystem.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include "DebuggerInterface.hpp"
+#include "TimeInterface.hpp"
+
+//-----------------------------------------------------------------------------------------------
+STATIC JobSystem* JobSystem::s_activeJobSystem = nullptr;
+
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+//Which deque belongs to the current thread; threads the job system didn't create (or adopt) have none
+static thread_local JobSystem::ThreadIndex s_currentThreadIndex = JobSystem::THREAD_NotInPool;
+#endif
+
+
+
+#pragma region Benchmark
+//-----------------------------------------------------------------------------------------------
+struct JobSystemBenchmarkWorkload
+{
+	JobSystemBenchmarkWorkload( std::vector< float >& data ) : values( data ) { }
+
+	void Run( JobRange& range )
+	{
+		for( size_t i = range.startIndex; i < range.endIndex; ++i )
+		{
+			float value = values[ i ];
+			for( unsigned int iteration = 0; iteration < 8; ++iteration )
+			{
+				value = std::sqrt( value * value + 1.f ) * 0.5f;
+			}
+			values[ i ] = value;
+		}
+	}
+
+	std::vector< float >& values;
+};
+
+//-----------------------------------------------------------------------------------------------
+void BenchmarkJobSystemScaling( size_t numberOfElements )
+{
+	static const unsigned int NUMBER_OF_PASSES = 10;
+	static const size_t ELEMENTS_PER_JOB = 4096;
+
+	unsigned int maxNumberOfThreads = 1;
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	maxNumberOfThreads = std::thread::hardware_concurrency();
+	if( maxNumberOfThreads == 0 )
+		maxNumberOfThreads = 1;
+#endif
+
+	std::vector< float > values( numberOfElements, 1.f );
+	JobSystemBenchmarkWorkload workload( values );
+	ParallelForBody body = ParallelForBody::GenerateFromOneArgFunction< JobSystemBenchmarkWorkload, &JobSystemBenchmarkWorkload::Run >( &workload );
+
+	double singleThreadSeconds = 0.0;
+	for( unsigned int numberOfThreads = 1; numberOfThreads <= maxNumberOfThreads; ++numberOfThreads )
+	{
+		JobSystem::Startup( numberOfThreads - 1 );
+
+		double startTimeSeconds = GetCurrentTimeSeconds();
+		for( unsigned int pass = 0; pass < NUMBER_OF_PASSES; ++pass )
+		{
+			JobSystem::ParallelFor( numberOfElements, ELEMENTS_PER_JOB, body );
+		}
+		double elapsedSeconds = GetCurrentTimeSeconds() - startTimeSeconds;
+
+		JobSystem::Shutdown();
+
+		if( numberOfThreads == 1 )
+			singleThreadSeconds = elapsedSeconds;
+
+		PrintfToDebuggerOutput( "ParallelFor x%u (%u passes) on %u thread(s): %.3f ms (%.2fx)\n",
+			static_cast< unsigned int >( numberOfElements ), NUMBER_OF_PASSES, numberOfThreads,
+			elapsedSeconds * 1000.0, singleThreadSeconds / elapsedSeconds );
+	}
+}
+#pragma endregion //Benchmark
+
+
+
+#pragma region Lifecycle
+//-----------------------------------------------------------------------------------------------
+/* A numberOfWorkerThreads of 0 uses one worker per remaining hardware thread.
+	The thread calling Startup becomes thread 0 of the pool and must also be the one to call Shutdown. */
+STATIC void JobSystem::Startup( unsigned int numberOfWorkerThreads )
+{
+	FATAL_ASSERTION( s_activeJobSystem == nullptr, "Job System Error",
+		"The job system was started up twice!" );
+
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	if( numberOfWorkerThreads == 0 )
+	{
+		unsigned int numberOfHardwareThreads = std::thread::hardware_concurrency();
+		if( numberOfHardwareThreads > 1 )
+			numberOfWorkerThreads = numberOfHardwareThreads - 1;
+	}
+#else
+	numberOfWorkerThreads = 0;
+#endif
+
+	s_activeJobSystem = new JobSystem( numberOfWorkerThreads );
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC void JobSystem::Shutdown()
+{
+	delete s_activeJobSystem;
+	s_activeJobSystem = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+JobSystem::JobSystem( unsigned int numberOfWorkerThreads )
+	: m_numberOfThreads( numberOfWorkerThreads + 1 )
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	, m_numberOfQueuedJobs( 0 )
+	, m_isShuttingDown( false )
+#endif
+{
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	m_jobDeques.reserve( m_numberOfThreads );
+	for( unsigned int i = 0; i < m_numberOfThreads; ++i )
+	{
+		m_jobDeques.push_back( new JobDeque() );
+	}
+
+	s_currentThreadIndex = 0;
+
+	m_workerThreads.reserve( numberOfWorkerThreads );
+	for( ThreadIndex i = 1; i < m_numberOfThreads; ++i )
+	{
+		m_workerThreads.push_back( std::thread( &JobSystem::WorkerThreadEntry, this, i ) );
+	}
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+JobSystem::~JobSystem()
+{
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	m_isShuttingDown = true;
+	WakeWorkers();
+
+	for( unsigned int i = 0; i < m_workerThreads.size(); ++i )
+	{
+		m_workerThreads[ i ].join();
+	}
+	m_workerThreads.clear();
+
+	for( unsigned int i = 0; i < m_jobDeques.size(); ++i )
+	{
+		delete m_jobDeques[ i ];
+	}
+	m_jobDeques.clear();
+
+	s_currentThreadIndex = THREAD_NotInPool;
+#endif
+}
+#pragma endregion //Lifecycle
+
+
+
+//-----------------------------------------------------------------------------------------------
+/* Jobs are pushed onto the caller's own deque in reverse order, so the caller pops them front
+	to back while idle workers steal from the far end of the range. The caller keeps working
+	(or stealing) until every job it pushed has finished. */
+void JobSystem::DoParallelFor( size_t numberOfElements, size_t elementsPerJob, const ParallelForBody& body )
+{
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	ThreadIndex callerIndex = s_currentThreadIndex;
+	if( callerIndex != THREAD_NotInPool && m_numberOfThreads > 1 )
+	{
+		size_t numberOfJobs = ( numberOfElements + elementsPerJob - 1 ) / elementsPerJob;
+		std::atomic< size_t > numberOfUnfinishedJobs( numberOfJobs );
+
+		Job job;
+		job.body = body;
+		job.numberOfUnfinishedJobs = &numberOfUnfinishedJobs;
+		for( size_t jobIndex = numberOfJobs; jobIndex > 0; --jobIndex )
+		{
+			job.range.startIndex = ( jobIndex - 1 ) * elementsPerJob;
+			job.range.endIndex = job.range.startIndex + elementsPerJob;
+			if( job.range.endIndex > numberOfElements )
+				job.range.endIndex = numberOfElements;
+
+			PushJob( callerIndex, job );
+		}
+		WakeWorkers();
+
+		Job jobToRun;
+		while( numberOfUnfinishedJobs.load() != 0 )
+		{
+			if( TryGetJob( callerIndex, jobToRun ) )
+				ExecuteJob( jobToRun );
+			else
+				std::this_thread::yield();
+		}
+		return;
+	}
+#endif
+
+	JobRange wholeRange( 0, numberOfElements );
+	body( wholeRange );
+}
+
+
+
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+#pragma region Scheduling
+//-----------------------------------------------------------------------------------------------
+void JobSystem::ExecuteJob( Job& job )
+{
+	job.body( job.range );
+	--( *job.numberOfUnfinishedJobs );
+}
+
+//-----------------------------------------------------------------------------------------------
+void JobSystem::PushJob( ThreadIndex threadIndex, const Job& job )
+{
+	JobDeque& deque = *m_jobDeques[ threadIndex ];
+	std::lock_guard< std::mutex > dequeLock( deque.mutex );
+	deque.jobs.push_back( job );
+	++m_numberOfQueuedJobs;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool JobSystem::TryPopOwnJob( ThreadIndex threadIndex, Job& out_job )
+{
+	JobDeque& deque = *m_jobDeques[ threadIndex ];
+	std::lock_guard< std::mutex > dequeLock( deque.mutex );
+	if( deque.jobs.empty() )
+		return false;
+
+	out_job = deque.jobs.back();
+	deque.jobs.pop_back();
+	--m_numberOfQueuedJobs;
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool JobSystem::TryStealJob( ThreadIndex thiefIndex, Job& out_job )
+{
+	for( unsigned int offset = 1; offset < m_numberOfThreads; ++offset )
+	{
+		JobDeque& victimDeque = *m_jobDeques[ ( thiefIndex + offset ) % m_numberOfThreads ];
+		std::lock_guard< std::mutex > dequeLock( victimDeque.mutex );
+		if( victimDeque.jobs.empty() )
+			continue;
+
+		out_job = victimDeque.jobs.front();
+		victimDeque.jobs.pop_front();
+		--m_numberOfQueuedJobs;
+		return true;
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool JobSystem::TryGetJob( ThreadIndex threadIndex, Job& out_job )
+{
+	if( m_numberOfQueuedJobs.load() == 0 )
+		return false;
+
+	return TryPopOwnJob( threadIndex, out_job ) || TryStealJob( threadIndex, out_job );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Taking the sleep mutex before notifying means no worker can be between checking for work
+	and starting to wait, so a wakeup is never lost. */
+void JobSystem::WakeWorkers()
+{
+	{
+		std::lock_guard< std::mutex > sleepLock( m_sleepMutex );
+	}
+	m_wakeCondition.notify_all();
+}
+
+//-----------------------------------------------------------------------------------------------
+void JobSystem::RunWorker( ThreadIndex threadIndex )
+{
+	s_currentThreadIndex = threadIndex;
+
+	Job job;
+	while( !m_isShuttingDown.load() )
+	{
+		if( TryGetJob( threadIndex, job ) )
+		{
+			ExecuteJob( job );
+			continue;
+		}
+
+		std::unique_lock< std::mutex > sleepLock( m_sleepMutex );
+		while( !m_isShuttingDown.load() && m_numberOfQueuedJobs.load() == 0 )
+		{
+			m_wakeCondition.wait( sleepLock );
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+STATIC void JobSystem::WorkerThreadEntry( JobSystem* jobSystem, ThreadIndex threadIndex )
+{
+	jobSystem->RunWorker( threadIndex );
+}
+#pragma endregion //Scheduling
+#endif
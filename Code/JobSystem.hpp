@@ -0,0 +1,158 @@
+#pragma once
+#ifndef INCLUDED_JOB_SYSTEM_HPP
+#define INCLUDED_JOB_SYSTEM_HPP
+
+//-----------------------------------------------------------------------------------------------
+#include <cstddef>
+
+#include "AssertionError.hpp"
+#include "Delegate.hpp"
+#include "EngineMacros.hpp"
+
+//-----------------------------------------------------------------------------------------------
+/* Single-threaded platforms (see EngineMacros.hpp) run every job inline on the calling thread.
+	The interface is identical, so systems don't need to care which one they get. */
+#if defined( PLATFORM_SINGLE_THREADED )
+	#define JOB_SYSTEM_SINGLE_THREADED
+#endif
+
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	#include <atomic>
+	#include <condition_variable>
+	#include <deque>
+	#include <mutex>
+	#include <thread>
+	#include <vector>
+#endif
+
+//-----------------------------------------------------------------------------------------------
+//Benchmark timing the same ParallelFor workload with 1 through N threads
+void BenchmarkJobSystemScaling( size_t numberOfElements = 1000000 );
+
+
+
+//-----------------------------------------------------------------------------------------------
+//The half-open range of element indices [startIndex, endIndex) handed to one job
+struct JobRange
+{
+	JobRange() : startIndex( 0 ), endIndex( 0 ) { }
+	JobRange( size_t start, size_t end ) : startIndex( start ), endIndex( end ) { }
+
+	size_t startIndex;
+	size_t endIndex;
+};
+
+typedef Delegate< void, JobRange > ParallelForBody;
+
+
+
+//-----------------------------------------------------------------------------------------------
+/* A fixed pool of worker threads with one job deque per thread. Each thread pops its own
+	newest jobs first and, when its deque runs dry, steals the oldest jobs from the others.
+	The thread that calls ParallelFor works on its own jobs while it waits, so nested
+	ParallelFor calls from inside a job are fine.
+
+	If the job system hasn't been started, ParallelFor simply runs the body on the caller. */
+SINGLETON class JobSystem
+{
+public:
+	typedef unsigned int ThreadIndex;
+	static const ThreadIndex THREAD_NotInPool = 0xffffffff;
+
+	//Lifecycle
+	static void Startup( unsigned int numberOfWorkerThreads = 0 );
+	static void Shutdown();
+
+	//Static Public Interface
+	static unsigned int GetNumberOfThreads();
+	static void ParallelFor( size_t numberOfElements, size_t elementsPerJob, const ParallelForBody& body );
+
+
+private:
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	//-------------------------------------------------------------------------------------------
+	struct Job
+	{
+		ParallelForBody body;
+		JobRange range;
+		std::atomic< size_t >* numberOfUnfinishedJobs;
+	};
+
+	//-------------------------------------------------------------------------------------------
+	struct JobDeque
+	{
+		std::mutex mutex;
+		std::deque< Job > jobs;
+	};
+#endif
+
+	JobSystem( unsigned int numberOfWorkerThreads );
+	~JobSystem();
+
+	//Private Instance Interface
+	void DoParallelFor( size_t numberOfElements, size_t elementsPerJob, const ParallelForBody& body );
+
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	//Scheduling
+	void ExecuteJob( Job& job );
+	void PushJob( ThreadIndex threadIndex, const Job& job );
+	bool TryPopOwnJob( ThreadIndex threadIndex, Job& out_job );
+	bool TryStealJob( ThreadIndex thiefIndex, Job& out_job );
+	bool TryGetJob( ThreadIndex threadIndex, Job& out_job );
+	void WakeWorkers();
+	void RunWorker( ThreadIndex threadIndex );
+
+	static void WorkerThreadEntry( JobSystem* jobSystem, ThreadIndex threadIndex );
+#endif
+
+	//Static Members
+	static JobSystem* s_activeJobSystem;
+
+	//Data Members
+	unsigned int m_numberOfThreads;
+
+#if !defined( JOB_SYSTEM_SINGLE_THREADED )
+	std::vector< JobDeque* > m_jobDeques; //Index 0 belongs to the thread that started the system
+	std::vector< std::thread > m_workerThreads;
+
+	std::atomic< size_t > m_numberOfQueuedJobs;
+	std::atomic< bool > m_isShuttingDown;
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wakeCondition;
+#endif
+};
+
+
+
+#pragma region Static Public Interface
+//-----------------------------------------------------------------------------------------------
+STATIC inline unsigned int JobSystem::GetNumberOfThreads()
+{
+	if( s_activeJobSystem == nullptr )
+		return 1;
+	return s_activeJobSystem->m_numberOfThreads;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Splits [0, numberOfElements) into jobs of elementsPerJob elements and returns once all of them
+	have run. The body may run on any thread, so it must only write to the elements in its range. */
+STATIC inline void JobSystem::ParallelFor( size_t numberOfElements, size_t elementsPerJob, const ParallelForBody& body )
+{
+	FATAL_ASSERTION( elementsPerJob != 0, "Job System Error",
+		"ParallelFor was asked to split work into jobs of zero elements!" );
+
+	if( numberOfElements == 0 )
+		return;
+
+	if( s_activeJobSystem == nullptr || numberOfElements <= elementsPerJob )
+	{
+		JobRange wholeRange( 0, numberOfElements );
+		body( wholeRange );
+		return;
+	}
+
+	s_activeJobSystem->DoParallelFor( numberOfElements, elementsPerJob, body );
+}
+#pragma endregion //Static Public Interface
+
+#endif //INCLUDED_JOB_SYSTEM_HPP
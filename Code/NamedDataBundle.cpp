@@ -43,3 +43,166 @@ void UnitTestNamedDataBundle()
 	testParameters.Clear();
 	//testParameters.GetParameterOrDie( "name", name );
 }
+
+
+
+#pragma region Lifecycle
+//-----------------------------------------------------------------------------------------------
+NamedDataBundle::NamedDataBundle( const NamedDataBundle& other )
+	: m_parameters( m_inlineParameters )
+	, m_numberOfParameters( 0 )
+	, m_parameterCapacity( INLINE_PARAMETER_CAPACITY )
+{
+	*this = other;
+}
+
+//-----------------------------------------------------------------------------------------------
+NamedDataBundle& NamedDataBundle::operator=( const NamedDataBundle& other )
+{
+	if( &other == this )
+		return *this;
+
+	Clear();
+	ReserveParameters( other.m_numberOfParameters );
+	for( unsigned int i = 0; i < other.m_numberOfParameters; ++i )
+	{
+		Parameter& parameter = m_parameters[ i ];
+		const Parameter& otherParameter = other.m_parameters[ i ];
+
+		parameter.nameHash = otherParameter.nameHash;
+		parameter.type = otherParameter.type;
+		parameter.type->copyConstruct( parameter.value, otherParameter.value );
+		++m_numberOfParameters;
+	}
+	return *this;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Keeps the parameter array, so the bundle can be refilled without allocating. */
+void NamedDataBundle::Clear()
+{
+	for( unsigned int i = 0; i < m_numberOfParameters; ++i )
+	{
+		m_parameters[ i ].type->destroy( m_parameters[ i ].value );
+	}
+	m_numberOfParameters = 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Heap arrays change hands without copying, and inline parameters are relocated through a
+	temporary bundle's own inline array, so swapping never allocates. */
+void NamedDataBundle::Swap( NamedDataBundle& other )
+{
+	if( &other == this )
+		return;
+
+	NamedDataBundle swapSpace;
+	swapSpace.TakeParametersFrom( *this );
+	TakeParametersFrom( other );
+	other.TakeParametersFrom( swapSpace );
+}
+#pragma endregion //Lifecycle
+
+
+
+#pragma region Parameter Array
+//-----------------------------------------------------------------------------------------------
+unsigned int NamedDataBundle::FindFirstParameterNotBefore( HashedString::Hash nameHash ) const
+{
+	unsigned int firstIndex = 0;
+	unsigned int numberOfCandidates = m_numberOfParameters;
+	while( numberOfCandidates > 0 )
+	{
+		unsigned int halfOfCandidates = numberOfCandidates / 2;
+		if( m_parameters[ firstIndex + halfOfCandidates ].nameHash < nameHash )
+		{
+			firstIndex += halfOfCandidates + 1;
+			numberOfCandidates -= halfOfCandidates + 1;
+		}
+		else
+			numberOfCandidates = halfOfCandidates;
+	}
+	return firstIndex;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* The new parameter has its name but no type or value yet; the caller must construct one. */
+NamedDataBundle::Parameter& NamedDataBundle::InsertParameterAt( unsigned int parameterIndex, HashedString::Hash nameHash )
+{
+	ReserveParameters( m_numberOfParameters + 1 );
+
+	for( unsigned int i = m_numberOfParameters; i > parameterIndex; --i )
+	{
+		Parameter& parameter = m_parameters[ i ];
+		Parameter& previousParameter = m_parameters[ i - 1 ];
+
+		parameter.nameHash = previousParameter.nameHash;
+		parameter.type = previousParameter.type;
+		parameter.type->relocate( parameter.value, previousParameter.value );
+	}
+	++m_numberOfParameters;
+
+	m_parameters[ parameterIndex ].nameHash = nameHash;
+	return m_parameters[ parameterIndex ];
+}
+
+//-----------------------------------------------------------------------------------------------
+void NamedDataBundle::ReserveParameters( unsigned int minimumCapacity )
+{
+	if( minimumCapacity <= m_parameterCapacity )
+		return;
+
+	unsigned int newCapacity = m_parameterCapacity * 2;
+	if( newCapacity < minimumCapacity )
+		newCapacity = minimumCapacity;
+
+	Parameter* newParameters = new Parameter[ newCapacity ];
+	for( unsigned int i = 0; i < m_numberOfParameters; ++i )
+	{
+		newParameters[ i ].nameHash = m_parameters[ i ].nameHash;
+		newParameters[ i ].type = m_parameters[ i ].type;
+		newParameters[ i ].type->relocate( newParameters[ i ].value, m_parameters[ i ].value );
+	}
+
+	if( !IsUsingInlineParameters() )
+		delete[] m_parameters;
+	m_parameters = newParameters;
+	m_parameterCapacity = newCapacity;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* This bundle must be empty. A heap array is adopted outright, leaving source on its inline
+	array; inline parameters are relocated one at a time. Either way source ends up empty. */
+void NamedDataBundle::TakeParametersFrom( NamedDataBundle& source )
+{
+	FATAL_ASSERTION( m_numberOfParameters == 0, "Named Data Bundle Error",
+		"Parameters can only be taken by an empty bundle!" );
+
+	if( !source.IsUsingInlineParameters() )
+	{
+		if( !IsUsingInlineParameters() )
+			delete[] m_parameters;
+
+		m_parameters = source.m_parameters;
+		m_numberOfParameters = source.m_numberOfParameters;
+		m_parameterCapacity = source.m_parameterCapacity;
+
+		source.m_parameters = source.m_inlineParameters;
+		source.m_numberOfParameters = 0;
+		source.m_parameterCapacity = INLINE_PARAMETER_CAPACITY;
+		return;
+	}
+
+	for( unsigned int i = 0; i < source.m_numberOfParameters; ++i )
+	{
+		Parameter& parameter = m_parameters[ i ];
+		Parameter& sourceParameter = source.m_parameters[ i ];
+
+		parameter.nameHash = sourceParameter.nameHash;
+		parameter.type = sourceParameter.type;
+		parameter.type->relocate( parameter.value, sourceParameter.value );
+	}
+	m_numberOfParameters = source.m_numberOfParameters;
+	source.m_numberOfParameters = 0;
+}
+#pragma endregion //Parameter Array
@@ -3,73 +3,109 @@
 #pragma once
 
 //-----------------------------------------------------------------------------------------------
-#include <map>
+#include <new>
 #include <typeinfo>
 
 #include "AssertionError.hpp"
 #include "DialogInterface.hpp"
 #include "HashedString.hpp"
 
-class ParameterIterator;
-
 //-----------------------------------------------------------------------------------------------
 //Unit Testing class to confirm working functionality
 void UnitTestNamedDataBundle();
 
 //-----------------------------------------------------------------------------------------------
+/* Parameters are kept in an array sorted by name hash, and the first few live inside the bundle
+	itself, so a bundle with a handful of small parameters never touches the heap. Each value is
+	stored in its parameter when it fits in INLINE_VALUE_BYTES and on the heap otherwise. Clear()
+	destroys the values but keeps any array the bundle has grown, so a bundle that's refilled
+	every frame stops allocating once it has seen its largest frame.
+
+	Values are tagged with a per-type table of copy and destroy functions instead of being
+	looked up through RTTI. Parameters are named by HashedStringView, so filling a bundle never
+	touches the HashedString intern table, and only name hashes are compared. */
 class NamedDataBundle
 {
+public:
+	static const size_t INLINE_VALUE_BYTES = 32;
+	static const unsigned int INLINE_PARAMETER_CAPACITY = 4;
+
+
+private:
 #pragma region Contained Parameter Class Declarations
 	//-------------------------------------------------------------------------------------------
-	class NamedDataItem
+	union ValueStorage
 	{
-	public:
-		virtual ~NamedDataItem() { }
+		unsigned char bytes[ INLINE_VALUE_BYTES ];
+		void* heapValue;
+
+		//Only here to align the bytes for any value that fits
+		double alignmentDouble;
+		long long alignmentLongLong;
 	};
-	
+
 	//-------------------------------------------------------------------------------------------
-	template< typename DataType >
-	class NamedDataItemOfType : public NamedDataItem
+	/* One table per stored type; its address doubles as the type's tag. The tables are left
+		non-const so the linker can't fold two types' identical tables into one. */
+	struct ValueType
 	{
-	public:
-		NamedDataItemOfType( DataType newDataItem )
-		{
-			dataItem = newDataItem;
-		}
-
-		DataType dataItem;
+		void ( *copyConstruct )( ValueStorage& destination, const ValueStorage& source );
+		void ( *relocate )( ValueStorage& destination, ValueStorage& source );
+		void ( *destroy )( ValueStorage& value );
 	};
 
-	typedef std::map< HashedString, NamedDataItem* > NameToDataMap;
-
 	//-------------------------------------------------------------------------------------------
-	class Iterator
+	template< typename DataType, bool fitsInline = ( sizeof( DataType ) <= INLINE_VALUE_BYTES && __alignof( DataType ) <= __alignof( ValueStorage ) ) >
+	struct StoredValue
 	{
-			friend class NamedDataBundle;
-			Iterator( NameToDataMap::iterator& startIterator ) : m_actualIterator( startIterator ) { }
+		static DataType& Get( ValueStorage& value ) { return *reinterpret_cast< DataType* >( value.bytes ); }
+		static void Construct( ValueStorage& value, const DataType& dataItem ) { new ( value.bytes ) DataType( dataItem ); }
+		static void CopyConstruct( ValueStorage& destination, const ValueStorage& source ) { new ( destination.bytes ) DataType( *reinterpret_cast< const DataType* >( source.bytes ) ); }
+		static void Relocate( ValueStorage& destination, ValueStorage& source ) { CopyConstruct( destination, source ); Destroy( source ); }
+		static void Destroy( ValueStorage& value ) { Get( value ).~DataType(); }
 
-		public:
-			void Advance() { ++m_actualIterator; }
-			void Retreat() { --m_actualIterator; }
+		static ValueType s_type;
+	};
 
-			void GetParameterName( HashedString& out_parameterName ) const { out_parameterName = m_actualIterator->first; }
-			template< typename DataType >
-			void GetParameterOrDie( DataType& out_typedParameter );
+	//-------------------------------------------------------------------------------------------
+	template< typename DataType >
+	struct StoredValue< DataType, false >
+	{
+		static DataType& Get( ValueStorage& value ) { return *static_cast< DataType* >( value.heapValue ); }
+		static void Construct( ValueStorage& value, const DataType& dataItem ) { value.heapValue = new DataType( dataItem ); }
+		static void CopyConstruct( ValueStorage& destination, const ValueStorage& source ) { destination.heapValue = new DataType( *static_cast< const DataType* >( source.heapValue ) ); }
+		static void Relocate( ValueStorage& destination, ValueStorage& source ) { destination.heapValue = source.heapValue; }
+		static void Destroy( ValueStorage& value ) { delete static_cast< DataType* >( value.heapValue ); }
+
+		static ValueType s_type;
+	};
 
-		private:
-			NameToDataMap::iterator m_actualIterator;
+	//-------------------------------------------------------------------------------------------
+	struct Parameter
+	{
+		HashedString::Hash nameHash;
+		const ValueType* type;
+		ValueStorage value;
 	};
 #pragma endregion
 
 public:
+	NamedDataBundle();
+	NamedDataBundle( const NamedDataBundle& other );
 	~NamedDataBundle();
 
-	void Clear() { m_nameToDataMapping.clear(); }
+	NamedDataBundle& operator=( const NamedDataBundle& other );
+
+	void Clear();
+	void Swap( NamedDataBundle& other );
+
+	unsigned int GetNumberOfParameters() const { return m_numberOfParameters; }
+	bool HasParameter( const HashedStringView& propertyName ) const;
 
 	template< typename DataType >
-	void GetParameterOrDie( const HashedString& propertyName, DataType& out_typedParameter );
+	void GetParameterOrDie( const HashedStringView& propertyName, DataType& out_typedParameter );
 
-	void GetParameterOrDie( const HashedString& propertyName, unsigned int& out_unsignedInteger )
+	void GetParameterOrDie( const HashedStringView& propertyName, unsigned int& out_unsignedInteger )
 	{
 		int actualIntegerTypeStored;
 		GetParameterOrDie( propertyName, actualIntegerTypeStored );
@@ -77,68 +113,102 @@ public:
 	}
 
 	template< typename DataType >
-	void SetParameter( const HashedString& propertyName, const DataType& typedParameter );
+	void SetParameter( const HashedStringView& propertyName, const DataType& typedParameter );
 
-	void SetParameter( const HashedString& propertyName, const char* stringLiteralParameter )
+	void SetParameter( const HashedStringView& propertyName, const char* stringLiteralParameter )
 	{
 		SetParameter( propertyName, std::string( stringLiteralParameter ) );
 	}
 
 
 private:
-	NameToDataMap m_nameToDataMapping;
+	//Parameter Array
+	unsigned int FindFirstParameterNotBefore( HashedString::Hash nameHash ) const;
+	Parameter& InsertParameterAt( unsigned int parameterIndex, HashedString::Hash nameHash );
+	void ReserveParameters( unsigned int minimumCapacity );
+	void TakeParametersFrom( NamedDataBundle& source );
+	bool IsUsingInlineParameters() const { return m_parameters == m_inlineParameters; }
+
+	//Data Members
+	Parameter* m_parameters; //Either m_inlineParameters or a heap array
+	unsigned int m_numberOfParameters;
+	unsigned int m_parameterCapacity;
+	Parameter m_inlineParameters[ INLINE_PARAMETER_CAPACITY ];
+};
+
+//-----------------------------------------------------------------------------------------------
+template< typename DataType, bool fitsInline >
+NamedDataBundle::ValueType NamedDataBundle::StoredValue< DataType, fitsInline >::s_type =
+{
+	&NamedDataBundle::StoredValue< DataType, fitsInline >::CopyConstruct,
+	&NamedDataBundle::StoredValue< DataType, fitsInline >::Relocate,
+	&NamedDataBundle::StoredValue< DataType, fitsInline >::Destroy
+};
+
+//-----------------------------------------------------------------------------------------------
+template< typename DataType >
+NamedDataBundle::ValueType NamedDataBundle::StoredValue< DataType, false >::s_type =
+{
+	&NamedDataBundle::StoredValue< DataType, false >::CopyConstruct,
+	&NamedDataBundle::StoredValue< DataType, false >::Relocate,
+	&NamedDataBundle::StoredValue< DataType, false >::Destroy
 };
 
+
+
+//-----------------------------------------------------------------------------------------------
+inline NamedDataBundle::NamedDataBundle()
+	: m_parameters( m_inlineParameters )
+	, m_numberOfParameters( 0 )
+	, m_parameterCapacity( INLINE_PARAMETER_CAPACITY )
+{
+}
+
 //-----------------------------------------------------------------------------------------------
 inline NamedDataBundle::~NamedDataBundle()
 {
-	for( NameToDataMap::iterator dataPair = m_nameToDataMapping.begin();
-		 dataPair != m_nameToDataMapping.end();
-		 ++dataPair )
-	{
-		delete dataPair->second;
-	}
+	Clear();
+	if( !IsUsingInlineParameters() )
+		delete[] m_parameters;
 }
 
+//-----------------------------------------------------------------------------------------------
+inline bool NamedDataBundle::HasParameter( const HashedStringView& propertyName ) const
+{
+	unsigned int parameterIndex = FindFirstParameterNotBefore( propertyName.GetHash() );
+	return parameterIndex < m_numberOfParameters && m_parameters[ parameterIndex ].nameHash == propertyName.GetHash();
+}
 
 //-----------------------------------------------------------------------------------------------
 template< typename DataType >
-inline void NamedDataBundle::GetParameterOrDie( const HashedString& propertyName, DataType& out_typedParameter )
+inline void NamedDataBundle::GetParameterOrDie( const HashedStringView& propertyName, DataType& out_typedParameter )
 {
 	static const std::string errorMessageBoxTitle = "Vingine Error: Bad NamedParameter";
-	if( m_nameToDataMapping.empty() )
+	if( m_numberOfParameters == 0 )
 	{
-		std::string errorMessage = " ERROR: Attempted to get parameter \"" + propertyName.GetString() + "\" from empty NamedParameters!\n";
+		std::string errorMessage = " ERROR: Attempted to get parameter \"" + std::string( propertyName.GetDebugText() ) + "\" from empty NamedParameters!\n";
 		PopUpSystemDialog( errorMessageBoxTitle, errorMessage );
 
 		ImmediatelyExit( -1 );
 	}
 
-	std::map< HashedString, NamedDataItem* >::iterator parameterIterator;
-	parameterIterator = m_nameToDataMapping.find( propertyName );
-
-	if( parameterIterator == m_nameToDataMapping.end() )
+	unsigned int parameterIndex = FindFirstParameterNotBefore( propertyName.GetHash() );
+	if( parameterIndex == m_numberOfParameters || m_parameters[ parameterIndex ].nameHash != propertyName.GetHash() )
 	{
-		std::string errorMessage = " ERROR: Parameter \"" + propertyName.GetString() + "\" not found in NamedParameters\n";
+		std::string errorMessage = " ERROR: Parameter \"" + std::string( propertyName.GetDebugText() ) + "\" not found in NamedParameters\n";
 		PopUpSystemDialog( errorMessageBoxTitle, errorMessage );
 
 		ImmediatelyExit( -1 );
 	}
 
-	NamedDataItemOfType< DataType >* parameterAsType = dynamic_cast< NamedDataItemOfType< DataType >* >( parameterIterator->second );
-	//If we successfully made the dynamic cast, output the object
-	if( parameterAsType != nullptr )
+	Parameter& parameter = m_parameters[ parameterIndex ];
+	if( parameter.type == &StoredValue< DataType >::s_type )
 	{
-		out_typedParameter = parameterAsType->dataItem;
+		out_typedParameter = StoredValue< DataType >::Get( parameter.value );
 	}
-	//if the type requested is a superclass of our class, then we can totally make that cast
-	//else if( typeid( ( ParameterType ) parameterIterator->second ) == typeid( out_typedParameter ) )
-	//{
-	//	
-	//}
 	else
 	{
-		std::string errorMessage = " ERROR: Parameter \"" + propertyName.GetString() + "\" in NamedParameters is not of type [" + typeid( DataType ).name() + "]\n";
+		std::string errorMessage = " ERROR: Parameter \"" + std::string( propertyName.GetDebugText() ) + "\" in NamedParameters is not of type [" + typeid( DataType ).name() + "]\n";
 		PopUpSystemDialog( errorMessageBoxTitle, errorMessage );
 
 		ImmediatelyExit( -1 );
@@ -147,9 +217,21 @@ inline void NamedDataBundle::GetParameterOrDie( const HashedString& propertyName
 
 //-----------------------------------------------------------------------------------------------
 template< typename DataType >
-inline void NamedDataBundle::SetParameter( const HashedString& propertyName, const DataType& typedParameter )
+inline void NamedDataBundle::SetParameter( const HashedStringView& propertyName, const DataType& typedParameter )
 {
-	m_nameToDataMapping[ propertyName ] = new NamedDataItemOfType< DataType >( typedParameter );
+	unsigned int parameterIndex = FindFirstParameterNotBefore( propertyName.GetHash() );
+
+	Parameter* parameter;
+	if( parameterIndex < m_numberOfParameters && m_parameters[ parameterIndex ].nameHash == propertyName.GetHash() )
+	{
+		parameter = &m_parameters[ parameterIndex ];
+		parameter->type->destroy( parameter->value );
+	}
+	else
+		parameter = &InsertParameterAt( parameterIndex, propertyName.GetHash() );
+
+	StoredValue< DataType >::Construct( parameter->value, typedParameter );
+	parameter->type = &StoredValue< DataType >::s_type;
 }
 
 #endif //INCLUDED_NAMED_DATA_BUNDLE_HPP
@@ -0,0 +1,200 @@
+#include "PhysicsBodyBatch.hpp"
+
+#include <math.h>
+
+#if defined( PHYSICS_KERNEL_USE_AVX )
+	#include <immintrin.h>
+#elif defined( PHYSICS_KERNEL_USE_SSE )
+	#include <xmmintrin.h>
+#endif
+
+#include "DebuggerInterface.hpp"
+#include "TimeInterface.hpp"
+
+
+
+//-----------------------------------------------------------------------------------------------
+static void IntegrateTerrestrialBodiesScalar( PhysicsBodyBatch& bodies, size_t firstBody, size_t endBody, const TerrestrialIntegrationStep& step )
+{
+	if( firstBody >= endBody )
+		return;
+
+	float* positionX = &bodies.positionX[ 0 ];
+	float* positionY = &bodies.positionY[ 0 ];
+	float* positionZ = &bodies.positionZ[ 0 ];
+	float* velocityX = &bodies.velocityX[ 0 ];
+	float* velocityY = &bodies.velocityY[ 0 ];
+	float* velocityZ = &bodies.velocityZ[ 0 ];
+	const float* gravityScale = &bodies.gravityScale[ 0 ];
+
+	const FloatVector3 gravityThisStep = step.gravityAcceleration * step.deltaSeconds;
+	for( size_t i = firstBody; i < endBody; ++i )
+	{
+		float newVelocityX = velocityX[ i ] + gravityThisStep.x * gravityScale[ i ];
+		float newVelocityY = velocityY[ i ] + gravityThisStep.y * gravityScale[ i ];
+		float newVelocityZ = velocityZ[ i ] + gravityThisStep.z * gravityScale[ i ];
+
+		positionX[ i ] += newVelocityX * step.deltaSeconds;
+		positionY[ i ] += newVelocityY * step.deltaSeconds;
+		float newPositionZ = positionZ[ i ] + newVelocityZ * step.deltaSeconds;
+
+		//Written as selects rather than an if so the compiler can emit max/blend instead of a branch
+		bool isBelowGround = ( newPositionZ < step.groundHeight );
+		positionZ[ i ] = isBelowGround ? step.groundHeight : newPositionZ;
+		velocityX[ i ] = newVelocityX * step.velocityRetainedThisStep;
+		velocityY[ i ] = newVelocityY * step.velocityRetainedThisStep;
+		velocityZ[ i ] = isBelowGround ? 0.f : newVelocityZ * step.velocityRetainedThisStep;
+	}
+}
+
+
+
+//-----------------------------------------------------------------------------------------------
+void BenchmarkTerrestrialIntegration( size_t numberOfBodies )
+{
+	static const unsigned int NUMBER_OF_STEPS = 100;
+	TerrestrialIntegrationStep step( FloatVector3( 0.f, 0.f, -9.81f ), 1.f / 60.f, 0.0018f, 2.f );
+
+	PhysicsBodyBatch bodies;
+	bodies.Resize( numberOfBodies );
+	for( size_t i = 0; i < numberOfBodies; ++i )
+	{
+		bodies.positionZ[ i ] = 2.f + static_cast< float >( i % 100 );
+		bodies.velocityX[ i ] = 1.f;
+		bodies.gravityScale[ i ] = 1.f;
+	}
+
+	double startTimeSeconds = GetCurrentTimeSeconds();
+	for( unsigned int i = 0; i < NUMBER_OF_STEPS; ++i )
+	{
+		IntegrateTerrestrialBodiesScalar( bodies, 0, numberOfBodies, step );
+	}
+	double scalarSecondsPerStep = ( GetCurrentTimeSeconds() - startTimeSeconds ) / NUMBER_OF_STEPS;
+
+	startTimeSeconds = GetCurrentTimeSeconds();
+	for( unsigned int i = 0; i < NUMBER_OF_STEPS; ++i )
+	{
+		IntegrateTerrestrialBodies( bodies, 0, numberOfBodies, step );
+	}
+	double kernelSecondsPerStep = ( GetCurrentTimeSeconds() - startTimeSeconds ) / NUMBER_OF_STEPS;
+
+#if defined( PHYSICS_KERNEL_USE_AVX )
+	static const char* KERNEL_NAME = "AVX";
+#elif defined( PHYSICS_KERNEL_USE_SSE )
+	static const char* KERNEL_NAME = "SSE";
+#else
+	static const char* KERNEL_NAME = "scalar";
+#endif
+
+	PrintfToDebuggerOutput( "Terrestrial integration x%u bodies: scalar %.3f ms/step, %s kernel %.3f ms/step\n",
+		static_cast< unsigned int >( numberOfBodies ), scalarSecondsPerStep * 1000.0, KERNEL_NAME, kernelSecondsPerStep * 1000.0 );
+}
+
+
+
+//-----------------------------------------------------------------------------------------------
+void PhysicsBodyBatch::Resize( size_t numberOfBodies )
+{
+	positionX.resize( numberOfBodies, 0.f );
+	positionY.resize( numberOfBodies, 0.f );
+	positionZ.resize( numberOfBodies, 0.f );
+	velocityX.resize( numberOfBodies, 0.f );
+	velocityY.resize( numberOfBodies, 0.f );
+	velocityZ.resize( numberOfBodies, 0.f );
+	gravityScale.resize( numberOfBodies, 0.f );
+}
+
+
+
+//-----------------------------------------------------------------------------------------------
+TerrestrialIntegrationStep::TerrestrialIntegrationStep( const FloatVector3& gravity, float stepSeconds, float velocityRetainedPerSecond, float groundZ )
+	: gravityAcceleration( gravity )
+	, deltaSeconds( stepSeconds )
+	, velocityRetainedThisStep( powf( velocityRetainedPerSecond, stepSeconds ) )
+	, groundHeight( groundZ )
+{ }
+
+//-----------------------------------------------------------------------------------------------
+/* The vector loops use unaligned loads, since the batch's channels are plain vectors and ranges
+	handed out by ParallelFor can start anywhere. Whatever doesn't fill a full register at the end
+	of the range goes through the scalar loop. */
+void IntegrateTerrestrialBodies( PhysicsBodyBatch& bodies, size_t firstBody, size_t endBody, const TerrestrialIntegrationStep& step )
+{
+	if( firstBody >= endBody )
+		return;
+
+	size_t i = firstBody;
+
+#if defined( PHYSICS_KERNEL_USE_AVX )
+	static const size_t BODIES_PER_REGISTER = 8;
+
+	const __m256 deltaSeconds = _mm256_set1_ps( step.deltaSeconds );
+	const __m256 gravityX = _mm256_set1_ps( step.gravityAcceleration.x * step.deltaSeconds );
+	const __m256 gravityY = _mm256_set1_ps( step.gravityAcceleration.y * step.deltaSeconds );
+	const __m256 gravityZ = _mm256_set1_ps( step.gravityAcceleration.z * step.deltaSeconds );
+	const __m256 velocityRetained = _mm256_set1_ps( step.velocityRetainedThisStep );
+	const __m256 groundHeight = _mm256_set1_ps( step.groundHeight );
+
+	for( ; i + BODIES_PER_REGISTER <= endBody; i += BODIES_PER_REGISTER )
+	{
+		__m256 gravityScale = _mm256_loadu_ps( &bodies.gravityScale[ i ] );
+		__m256 velocityX = _mm256_add_ps( _mm256_loadu_ps( &bodies.velocityX[ i ] ), _mm256_mul_ps( gravityX, gravityScale ) );
+		__m256 velocityY = _mm256_add_ps( _mm256_loadu_ps( &bodies.velocityY[ i ] ), _mm256_mul_ps( gravityY, gravityScale ) );
+		__m256 velocityZ = _mm256_add_ps( _mm256_loadu_ps( &bodies.velocityZ[ i ] ), _mm256_mul_ps( gravityZ, gravityScale ) );
+
+		__m256 positionX = _mm256_add_ps( _mm256_loadu_ps( &bodies.positionX[ i ] ), _mm256_mul_ps( velocityX, deltaSeconds ) );
+		__m256 positionY = _mm256_add_ps( _mm256_loadu_ps( &bodies.positionY[ i ] ), _mm256_mul_ps( velocityY, deltaSeconds ) );
+		__m256 positionZ = _mm256_add_ps( _mm256_loadu_ps( &bodies.positionZ[ i ] ), _mm256_mul_ps( velocityZ, deltaSeconds ) );
+
+		__m256 isBelowGround = _mm256_cmp_ps( positionZ, groundHeight, _CMP_LT_OQ );
+		positionZ = _mm256_max_ps( positionZ, groundHeight );
+		velocityX = _mm256_mul_ps( velocityX, velocityRetained );
+		velocityY = _mm256_mul_ps( velocityY, velocityRetained );
+		velocityZ = _mm256_andnot_ps( isBelowGround, _mm256_mul_ps( velocityZ, velocityRetained ) );
+
+		_mm256_storeu_ps( &bodies.positionX[ i ], positionX );
+		_mm256_storeu_ps( &bodies.positionY[ i ], positionY );
+		_mm256_storeu_ps( &bodies.positionZ[ i ], positionZ );
+		_mm256_storeu_ps( &bodies.velocityX[ i ], velocityX );
+		_mm256_storeu_ps( &bodies.velocityY[ i ], velocityY );
+		_mm256_storeu_ps( &bodies.velocityZ[ i ], velocityZ );
+	}
+
+#elif defined( PHYSICS_KERNEL_USE_SSE )
+	static const size_t BODIES_PER_REGISTER = 4;
+
+	const __m128 deltaSeconds = _mm_set1_ps( step.deltaSeconds );
+	const __m128 gravityX = _mm_set1_ps( step.gravityAcceleration.x * step.deltaSeconds );
+	const __m128 gravityY = _mm_set1_ps( step.gravityAcceleration.y * step.deltaSeconds );
+	const __m128 gravityZ = _mm_set1_ps( step.gravityAcceleration.z * step.deltaSeconds );
+	const __m128 velocityRetained = _mm_set1_ps( step.velocityRetainedThisStep );
+	const __m128 groundHeight = _mm_set1_ps( step.groundHeight );
+
+	for( ; i + BODIES_PER_REGISTER <= endBody; i += BODIES_PER_REGISTER )
+	{
+		__m128 gravityScale = _mm_loadu_ps( &bodies.gravityScale[ i ] );
+		__m128 velocityX = _mm_add_ps( _mm_loadu_ps( &bodies.velocityX[ i ] ), _mm_mul_ps( gravityX, gravityScale ) );
+		__m128 velocityY = _mm_add_ps( _mm_loadu_ps( &bodies.velocityY[ i ] ), _mm_mul_ps( gravityY, gravityScale ) );
+		__m128 velocityZ = _mm_add_ps( _mm_loadu_ps( &bodies.velocityZ[ i ] ), _mm_mul_ps( gravityZ, gravityScale ) );
+
+		__m128 positionX = _mm_add_ps( _mm_loadu_ps( &bodies.positionX[ i ] ), _mm_mul_ps( velocityX, deltaSeconds ) );
+		__m128 positionY = _mm_add_ps( _mm_loadu_ps( &bodies.positionY[ i ] ), _mm_mul_ps( velocityY, deltaSeconds ) );
+		__m128 positionZ = _mm_add_ps( _mm_loadu_ps( &bodies.positionZ[ i ] ), _mm_mul_ps( velocityZ, deltaSeconds ) );
+
+		__m128 isBelowGround = _mm_cmplt_ps( positionZ, groundHeight );
+		positionZ = _mm_max_ps( positionZ, groundHeight );
+		velocityX = _mm_mul_ps( velocityX, velocityRetained );
+		velocityY = _mm_mul_ps( velocityY, velocityRetained );
+		velocityZ = _mm_andnot_ps( isBelowGround, _mm_mul_ps( velocityZ, velocityRetained ) );
+
+		_mm_storeu_ps( &bodies.positionX[ i ], positionX );
+		_mm_storeu_ps( &bodies.positionY[ i ], positionY );
+		_mm_storeu_ps( &bodies.positionZ[ i ], positionZ );
+		_mm_storeu_ps( &bodies.velocityX[ i ], velocityX );
+		_mm_storeu_ps( &bodies.velocityY[ i ], velocityY );
+		_mm_storeu_ps( &bodies.velocityZ[ i ], velocityZ );
+	}
+#endif
+
+	IntegrateTerrestrialBodiesScalar( bodies, i, endBody, step );
+}
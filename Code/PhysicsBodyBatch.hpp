@@ -0,0 +1,61 @@
+#pragma once
+#ifndef INCLUDED_PHYSICS_BODY_BATCH_HPP
+#define INCLUDED_PHYSICS_BODY_BATCH_HPP
+
+//-----------------------------------------------------------------------------------------------
+#include <vector>
+
+#include "Math/FloatVector3.hpp"
+#include "EngineMacros.hpp"
+
+//-----------------------------------------------------------------------------------------------
+//The widest instruction set the integration kernel was compiled for
+#if defined( __AVX__ )
+	#define PHYSICS_KERNEL_USE_AVX
+#elif defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 1 ) )
+	#define PHYSICS_KERNEL_USE_SSE
+#endif
+
+//-----------------------------------------------------------------------------------------------
+//Benchmark of the vectorized integration kernel against its scalar fallback
+void BenchmarkTerrestrialIntegration( size_t numberOfBodies = 1000000 );
+
+
+
+//-----------------------------------------------------------------------------------------------
+/* Packed structure-of-arrays copy of the kinematic state a physics system integrates.
+	Body i lives at index i of every channel, so the kernel can load several bodies per instruction. */
+struct PhysicsBodyBatch
+{
+	size_t GetNumberOfBodies() const { return positionX.size(); }
+	void Resize( size_t numberOfBodies );
+
+	//Data Members
+	std::vector< float > positionX;
+	std::vector< float > positionY;
+	std::vector< float > positionZ;
+	std::vector< float > velocityX;
+	std::vector< float > velocityY;
+	std::vector< float > velocityZ;
+	std::vector< float > gravityScale;
+};
+
+
+
+//-----------------------------------------------------------------------------------------------
+struct TerrestrialIntegrationStep
+{
+	TerrestrialIntegrationStep( const FloatVector3& gravity, float stepSeconds, float velocityRetainedPerSecond, float groundZ );
+
+	FloatVector3 gravityAcceleration;
+	float deltaSeconds;
+	float velocityRetainedThisStep; //Damping factor for this step's length, so damping doesn't depend on frame rate
+	float groundHeight;
+};
+
+//-----------------------------------------------------------------------------------------------
+/* Integrates bodies [firstBody, endBody) of the batch: gravity, then position, then damping, then
+	a clamp that keeps bodies from falling through the ground plane and kills their downward velocity. */
+void IntegrateTerrestrialBodies( PhysicsBodyBatch& bodies, size_t firstBody, size_t endBody, const TerrestrialIntegrationStep& step );
+
+#endif //INCLUDED_PHYSICS_BODY_BATCH_HPP
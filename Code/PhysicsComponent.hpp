@@ -3,22 +3,53 @@
 #define INCLUDED_PHYSICS_COMPONENT_HPP
 
 //-----------------------------------------------------------------------------------------------
+#include <vector>
+
 #include "Component.hpp"
+#include "SpatialHashGrid.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
 struct PhysicsComponent : public Component
 {
-	PhysicsComponent( float pctAcceleratedByGravity = 0.f );
+	PhysicsComponent( float pctAcceleratedByGravity = 0.f, float radius = 0.f );
+
+	//Sleeping bodies aren't integrated; anything that pushes or moves one must wake it
+	bool IsAwake() const { return isAwake; }
+	void WakeUp();
 
 	float percentAcceleratedByGravity;
+	float collisionRadius;
+	SpatialHashGrid::ItemID broadphaseItemID; //Managed by the physics system while its broadphase is enabled
+
+	//Sleep state (managed by the physics system)
+	bool isAwake;
+	float secondsAtRest;
+	std::vector< PhysicsComponent* >* wokenComponents; //Where the physics system picks up bodies woken between its updates
 };
 
 
 
 //-----------------------------------------------------------------------------------------------
-inline PhysicsComponent::PhysicsComponent( float pctAcceleratedByGravity )
+inline PhysicsComponent::PhysicsComponent( float pctAcceleratedByGravity, float radius )
 	: percentAcceleratedByGravity( pctAcceleratedByGravity )
+	, collisionRadius( radius )
+	, broadphaseItemID( SpatialHashGrid::ITEM_None )
+	, isAwake( true )
+	, secondsAtRest( 0.f )
+	, wokenComponents( nullptr )
 { }
 
+//-----------------------------------------------------------------------------------------------
+inline void PhysicsComponent::WakeUp()
+{
+	secondsAtRest = 0.f;
+	if( isAwake )
+		return;
+
+	isAwake = true;
+	if( wokenComponents != nullptr )
+		wokenComponents->push_back( this );
+}
+
 #endif //INCLUDED_PHYSICS_COMPONENT_HPP
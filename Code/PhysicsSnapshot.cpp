@@ -0,0 +1,86 @@
+#include "PhysicsSnapshot.hpp"
+
+#include <string.h>
+
+#include "DebuggerInterface.hpp"
+#include "Entity.hpp"
+#include "PhysicsComponent.hpp"
+#include "TerrestrialPhysicsSystem.hpp"
+#include "TimeInterface.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+void BenchmarkPhysicsSnapshot( unsigned int numberOfEntities )
+{
+	static const unsigned int NUMBER_OF_ROLLBACKS = 100;
+	static const float STEPS_PER_SECOND = 60.f;
+
+	std::vector< Entity > entities( numberOfEntities );
+	TerrestrialPhysicsSystem physics( FloatVector3( 0.f, 0.f, -9.81f ) );
+	physics.UseFixedTimestep( STEPS_PER_SECOND, 4 );
+	for( unsigned int i = 0; i < numberOfEntities; ++i )
+	{
+		entities[ i ].SetPosition( FloatVector3( static_cast< float >( i ), 0.f, 10.f + static_cast< float >( i % 50 ) ) );
+		entities[ i ].SetVelocity( FloatVector3( 1.f, 0.f, 0.f ) );
+
+		PhysicsComponent* physicsComponent = new PhysicsComponent( 1.f, 0.5f );
+		entities[ i ].AttachComponent( physicsComponent );
+		physics.AddPhysicsComponent( physicsComponent );
+	}
+	physics.SimulateFixedSteps( 10 );
+
+	PhysicsSnapshot snapshot;
+	physics.SaveSnapshot( snapshot );
+	std::vector< unsigned char > buffer( snapshot.GetSerializedSizeBytes() );
+
+	double startTimeSeconds = GetCurrentTimeSeconds();
+	for( unsigned int i = 0; i < NUMBER_OF_ROLLBACKS; ++i )
+	{
+		physics.SaveSnapshot( snapshot );
+		physics.RestoreSnapshot( snapshot );
+	}
+	double saveAndRestoreSeconds = ( GetCurrentTimeSeconds() - startTimeSeconds ) / NUMBER_OF_ROLLBACKS;
+
+	startTimeSeconds = GetCurrentTimeSeconds();
+	for( unsigned int i = 0; i < NUMBER_OF_ROLLBACKS; ++i )
+	{
+		snapshot.WriteToBuffer( &buffer[ 0 ] );
+		snapshot.ReadFromBuffer( &buffer[ 0 ], buffer.size() );
+	}
+	double serializeSeconds = ( GetCurrentTimeSeconds() - startTimeSeconds ) / NUMBER_OF_ROLLBACKS;
+
+	PrintfToDebuggerOutput( "Physics snapshot x%u entities (%u bytes): save+restore %.3f ms, write+read buffer %.3f ms\n",
+		numberOfEntities, static_cast< unsigned int >( buffer.size() ), saveAndRestoreSeconds * 1000.0, serializeSeconds * 1000.0 );
+
+	physics.OnDestruction();
+}
+
+
+
+//-----------------------------------------------------------------------------------------------
+void PhysicsSnapshot::WriteToBuffer( unsigned char* out_buffer ) const
+{
+	memcpy( out_buffer, &simulation, sizeof( SimulationState ) );
+	if( !bodies.empty() )
+		memcpy( out_buffer + sizeof( SimulationState ), &bodies[ 0 ], bodies.size() * sizeof( BodyState ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Returns false, leaving the snapshot untouched, if the buffer is too short for the body count
+	it claims to hold. The count is checked by division, so a corrupt count can't overflow it. */
+bool PhysicsSnapshot::ReadFromBuffer( const unsigned char* buffer, size_t bufferSizeBytes )
+{
+	if( bufferSizeBytes < sizeof( SimulationState ) )
+		return false;
+
+	SimulationState bufferedSimulation;
+	memcpy( &bufferedSimulation, buffer, sizeof( SimulationState ) );
+	if( bufferedSimulation.numberOfBodies > ( bufferSizeBytes - sizeof( SimulationState ) ) / sizeof( BodyState ) )
+		return false;
+
+	simulation = bufferedSimulation;
+	bodies.resize( simulation.numberOfBodies );
+	if( !bodies.empty() )
+		memcpy( &bodies[ 0 ], buffer + sizeof( SimulationState ), bodies.size() * sizeof( BodyState ) );
+	return true;
+}
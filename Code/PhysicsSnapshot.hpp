@@ -0,0 +1,66 @@
+#pragma once
+#ifndef INCLUDED_PHYSICS_SNAPSHOT_HPP
+#define INCLUDED_PHYSICS_SNAPSHOT_HPP
+
+//-----------------------------------------------------------------------------------------------
+#include <vector>
+
+#include "Math/EulerAngles.hpp"
+#include "Math/FloatVector3.hpp"
+#include "EntityHandle.hpp"
+
+//-----------------------------------------------------------------------------------------------
+//Benchmark of saving and restoring a physics system's full state, as rollback does every frame
+void BenchmarkPhysicsSnapshot( unsigned int numberOfEntities = 10000 );
+
+
+
+//-----------------------------------------------------------------------------------------------
+/* Everything a TerrestrialPhysicsSystem needs to resume simulating from an earlier moment:
+	the kinematics of every physics owner, each PhysicsComponent's data, and the system's own
+	timestep state. Bodies are stored in the same order as the system's components, along with
+	a handle to each owner so a restore can check it's putting them back on the same entities.
+
+	Both blocks are plain data, so a snapshot is serialized with two memcpys, and saving into
+	the same snapshot repeatedly reuses its storage instead of allocating. */
+struct PhysicsSnapshot
+{
+	//-------------------------------------------------------------------------------------------
+	struct SimulationState
+	{
+		float accumulatedSeconds;
+		float interpolationAlpha;
+		unsigned int numberOfBodies;
+	};
+
+	//-------------------------------------------------------------------------------------------
+	struct BodyState
+	{
+		EntityHandle owner;
+
+		//Owner kinematics
+		FloatVector3 position;
+		FloatVector3 previousPosition;
+		FloatVector3 velocity;
+		FloatVector3 acceleration;
+		EulerAngles orientation;
+		EulerAngles angularVelocity;
+
+		//PhysicsComponent data
+		float percentAcceleratedByGravity;
+		float collisionRadius;
+		float secondsAtRest;
+		unsigned int isAwake;
+	};
+
+	//Binary form
+	size_t GetSerializedSizeBytes() const { return sizeof( SimulationState ) + bodies.size() * sizeof( BodyState ); }
+	void WriteToBuffer( unsigned char* out_buffer ) const;
+	bool ReadFromBuffer( const unsigned char* buffer, size_t bufferSizeBytes );
+
+	//Data Members
+	SimulationState simulation;
+	std::vector< BodyState > bodies;
+};
+
+#endif //INCLUDED_PHYSICS_SNAPSHOT_HPP
@@ -0,0 +1,379 @@
+#include "SpatialHashGrid.hpp"
+
+#include "AssertionError.hpp"
+
+
+
+//-----------------------------------------------------------------------------------------------
+static float GetDistanceSquared( const FloatVector3& first, const FloatVector3& second )
+{
+	float deltaX = first.x - second.x;
+	float deltaY = first.y - second.y;
+	float deltaZ = first.z - second.z;
+	return deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Truncation plus a fixup, since floorf is an out-of-line library call on many of our targets.
+	Values are clamped first, since converting a float outside int's range (or a NaN) is undefined;
+	the limit leaves room to subtract two cell coordinates without overflowing. */
+static inline int FloorToInt( float value )
+{
+	static const float LARGEST_CELL_COORDINATE = 536870912.f; //2^29
+
+	if( !( value >= -LARGEST_CELL_COORDINATE ) ) //Written this way so NaN is clamped too
+		value = -LARGEST_CELL_COORDINATE;
+	else if( value > LARGEST_CELL_COORDINATE )
+		value = LARGEST_CELL_COORDINATE;
+
+	int truncatedValue = static_cast< int >( value );
+	return ( value < static_cast< float >( truncatedValue ) ) ? truncatedValue - 1 : truncatedValue;
+}
+
+//-----------------------------------------------------------------------------------------------
+static float ClampFloat( float value, float minimum, float maximum )
+{
+	if( value < minimum )
+		return minimum;
+	if( value > maximum )
+		return maximum;
+	return value;
+}
+
+
+
+#pragma region Visitors
+//-----------------------------------------------------------------------------------------------
+struct SpatialHashGrid::RadiusQueryVisitor
+{
+	RadiusQueryVisitor( const FloatVector3& queryCenter, float queryRadius, std::vector< ItemID >& results )
+		: center( queryCenter ), radius( queryRadius ), out_items( results ) { }
+
+	void operator()( ItemID itemID, const Item& item )
+	{
+		float touchingDistance = radius + item.radius;
+		if( GetDistanceSquared( center, item.position ) <= touchingDistance * touchingDistance )
+			out_items.push_back( itemID );
+	}
+
+	FloatVector3 center;
+	float radius;
+	std::vector< ItemID >& out_items;
+};
+
+//-----------------------------------------------------------------------------------------------
+struct SpatialHashGrid::BoxQueryVisitor
+{
+	BoxQueryVisitor( const FloatVector3& boxMinimums, const FloatVector3& boxMaximums, std::vector< ItemID >& results )
+		: minimums( boxMinimums ), maximums( boxMaximums ), out_items( results ) { }
+
+	void operator()( ItemID itemID, const Item& item )
+	{
+		FloatVector3 closestPointInBox( ClampFloat( item.position.x, minimums.x, maximums.x ),
+										ClampFloat( item.position.y, minimums.y, maximums.y ),
+										ClampFloat( item.position.z, minimums.z, maximums.z ) );
+		if( GetDistanceSquared( closestPointInBox, item.position ) <= item.radius * item.radius )
+			out_items.push_back( itemID );
+	}
+
+	FloatVector3 minimums;
+	FloatVector3 maximums;
+	std::vector< ItemID >& out_items;
+};
+
+//-----------------------------------------------------------------------------------------------
+//Only pairs with a higher-numbered partner are reported, so each overlap is reported once
+struct SpatialHashGrid::PairQueryVisitor
+{
+	PairQueryVisitor( ItemID firstItemID, const Item& firstItem, std::vector< ItemPair >& results )
+		: firstID( firstItemID ), first( firstItem ), out_pairs( results ) { }
+
+	void operator()( ItemID itemID, const Item& item )
+	{
+		if( itemID <= firstID )
+			return;
+
+		float touchingDistance = first.radius + item.radius;
+		if( GetDistanceSquared( first.position, item.position ) <= touchingDistance * touchingDistance )
+			out_pairs.push_back( ItemPair( firstID, itemID ) );
+	}
+
+	ItemID firstID;
+	const Item& first;
+	std::vector< ItemPair >& out_pairs;
+};
+#pragma endregion //Visitors
+
+
+
+//-----------------------------------------------------------------------------------------------
+/* The bucket count is rounded up to a power of two. */
+SpatialHashGrid::SpatialHashGrid( float cellSize, unsigned int numberOfBuckets )
+	: m_cellSize( cellSize )
+	, m_inverseCellSize( 1.f / cellSize )
+	, m_largestItemRadius( 0.f )
+	, m_numberOfItemsWithLargestRadius( 0 )
+	, m_numberOfItems( 0 )
+	, m_bucketMask( 0 )
+{
+	FATAL_ASSERTION( cellSize > 0.f, "Spatial Hash Error",
+		"Spatial hash grid cells must have a positive size!" );
+
+	unsigned int roundedNumberOfBuckets = 1;
+	while( roundedNumberOfBuckets < numberOfBuckets )
+	{
+		roundedNumberOfBuckets <<= 1;
+	}
+
+	m_bucketHeads.resize( roundedNumberOfBuckets );
+	m_bucketMask = roundedNumberOfBuckets - 1;
+	Clear();
+}
+
+
+
+#pragma region Items
+//-----------------------------------------------------------------------------------------------
+/* Item IDs of removed items are reused. */
+SpatialHashGrid::ItemID SpatialHashGrid::InsertItem( Entity* entity, const FloatVector3& position, float radius )
+{
+	ItemID newItemID;
+	if( m_freeItemIDs.empty() )
+	{
+		newItemID = m_items.size();
+		m_items.push_back( Item() );
+	}
+	else
+	{
+		newItemID = m_freeItemIDs.back();
+		m_freeItemIDs.pop_back();
+	}
+
+	Item& newItem = m_items[ newItemID ];
+	newItem.entity = entity;
+	newItem.position = position;
+	newItem.radius = radius;
+	newItem.cell = GetCellContainingPoint( position );
+	newItem.isInUse = true;
+	LinkItemIntoBucket( newItemID );
+
+	if( radius > m_largestItemRadius )
+	{
+		m_largestItemRadius = radius;
+		m_numberOfItemsWithLargestRadius = 0;
+	}
+	if( radius == m_largestItemRadius )
+		++m_numberOfItemsWithLargestRadius;
+
+	++m_numberOfItems;
+	return newItemID;
+}
+
+//-----------------------------------------------------------------------------------------------
+void SpatialHashGrid::MoveItem( ItemID item, const FloatVector3& newPosition )
+{
+	Item& movedItem = m_items[ item ];
+	FATAL_ASSERTION( movedItem.isInUse, "Spatial Hash Error",
+		"Attempted to move an item that was already removed from the grid!" );
+	movedItem.position = newPosition;
+
+	CellCoordinates newCell = GetCellContainingPoint( newPosition );
+	if( newCell == movedItem.cell )
+		return;
+
+	UnlinkItemFromBucket( item );
+	movedItem.cell = newCell;
+	LinkItemIntoBucket( item );
+}
+
+//-----------------------------------------------------------------------------------------------
+void SpatialHashGrid::RemoveItem( ItemID item )
+{
+	Item& removedItem = m_items[ item ];
+	if( !removedItem.isInUse )
+		return;
+
+	UnlinkItemFromBucket( item );
+	removedItem.isInUse = false;
+	removedItem.entity = nullptr;
+	m_freeItemIDs.push_back( item );
+	--m_numberOfItems;
+
+	if( removedItem.radius == m_largestItemRadius )
+	{
+		--m_numberOfItemsWithLargestRadius;
+		if( m_numberOfItemsWithLargestRadius == 0 )
+			RecalculateLargestItemRadius();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void SpatialHashGrid::Clear()
+{
+	m_items.clear();
+	m_freeItemIDs.clear();
+	m_numberOfItems = 0;
+	m_largestItemRadius = 0.f;
+	m_numberOfItemsWithLargestRadius = 0;
+	for( unsigned int i = 0; i < m_bucketHeads.size(); ++i )
+	{
+		m_bucketHeads[ i ] = ITEM_None;
+	}
+}
+#pragma endregion //Items
+
+
+
+#pragma region Queries
+//-----------------------------------------------------------------------------------------------
+void SpatialHashGrid::FindItemsInRadius( const FloatVector3& center, float radius, std::vector< ItemID >& out_items ) const
+{
+	float searchRadius = radius + m_largestItemRadius;
+	FloatVector3 searchExtents( searchRadius, searchRadius, searchRadius );
+
+	RadiusQueryVisitor visitor( center, radius, out_items );
+	VisitItemsInCellRange( GetCellContainingPoint( center - searchExtents ), GetCellContainingPoint( center + searchExtents ), visitor );
+}
+
+//-----------------------------------------------------------------------------------------------
+void SpatialHashGrid::FindItemsInBox( const FloatVector3& minimums, const FloatVector3& maximums, std::vector< ItemID >& out_items ) const
+{
+	FloatVector3 searchExtents( m_largestItemRadius, m_largestItemRadius, m_largestItemRadius );
+
+	BoxQueryVisitor visitor( minimums, maximums, out_items );
+	VisitItemsInCellRange( GetCellContainingPoint( minimums - searchExtents ), GetCellContainingPoint( maximums + searchExtents ), visitor );
+}
+
+//-----------------------------------------------------------------------------------------------
+void SpatialHashGrid::FindOverlappingPairs( std::vector< ItemPair >& out_pairs ) const
+{
+	for( ItemID i = 0; i < m_items.size(); ++i )
+	{
+		const Item& item = m_items[ i ];
+		if( !item.isInUse )
+			continue;
+
+		float searchRadius = item.radius + m_largestItemRadius;
+		FloatVector3 searchExtents( searchRadius, searchRadius, searchRadius );
+
+		PairQueryVisitor visitor( i, item, out_pairs );
+		VisitItemsInCellRange( GetCellContainingPoint( item.position - searchExtents ), GetCellContainingPoint( item.position + searchExtents ), visitor );
+	}
+}
+#pragma endregion //Queries
+
+
+
+#pragma region Helpers
+//-----------------------------------------------------------------------------------------------
+inline SpatialHashGrid::CellCoordinates SpatialHashGrid::GetCellContainingPoint( const FloatVector3& point ) const
+{
+	CellCoordinates cell;
+	cell.x = FloorToInt( point.x * m_inverseCellSize );
+	cell.y = FloorToInt( point.y * m_inverseCellSize );
+	cell.z = FloorToInt( point.z * m_inverseCellSize );
+	return cell;
+}
+
+//-----------------------------------------------------------------------------------------------
+inline unsigned int SpatialHashGrid::GetBucketForCell( const CellCoordinates& cell ) const
+{
+	unsigned int hash = ( static_cast< unsigned int >( cell.x ) * 73856093u )
+					  ^ ( static_cast< unsigned int >( cell.y ) * 19349663u )
+					  ^ ( static_cast< unsigned int >( cell.z ) * 83492791u );
+	return hash & m_bucketMask;
+}
+
+//-----------------------------------------------------------------------------------------------
+void SpatialHashGrid::LinkItemIntoBucket( ItemID item )
+{
+	Item& linkedItem = m_items[ item ];
+	ItemID& bucketHead = m_bucketHeads[ GetBucketForCell( linkedItem.cell ) ];
+
+	linkedItem.previousInBucket = ITEM_None;
+	linkedItem.nextInBucket = bucketHead;
+	if( bucketHead != ITEM_None )
+		m_items[ bucketHead ].previousInBucket = item;
+	bucketHead = item;
+}
+
+//-----------------------------------------------------------------------------------------------
+void SpatialHashGrid::UnlinkItemFromBucket( ItemID item )
+{
+	Item& unlinkedItem = m_items[ item ];
+
+	if( unlinkedItem.previousInBucket != ITEM_None )
+		m_items[ unlinkedItem.previousInBucket ].nextInBucket = unlinkedItem.nextInBucket;
+	else
+		m_bucketHeads[ GetBucketForCell( unlinkedItem.cell ) ] = unlinkedItem.nextInBucket;
+
+	if( unlinkedItem.nextInBucket != ITEM_None )
+		m_items[ unlinkedItem.nextInBucket ].previousInBucket = unlinkedItem.previousInBucket;
+
+	unlinkedItem.previousInBucket = unlinkedItem.nextInBucket = ITEM_None;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Only needed once the last item with the largest radius is removed, so removing a crowd of
+	same-sized items scans the items once rather than once per removal. */
+void SpatialHashGrid::RecalculateLargestItemRadius()
+{
+	m_largestItemRadius = 0.f;
+	m_numberOfItemsWithLargestRadius = 0;
+	for( ItemID i = 0; i < m_items.size(); ++i )
+	{
+		const Item& item = m_items[ i ];
+		if( !item.isInUse )
+			continue;
+
+		if( item.radius > m_largestItemRadius )
+		{
+			m_largestItemRadius = item.radius;
+			m_numberOfItemsWithLargestRadius = 0;
+		}
+		if( item.radius == m_largestItemRadius )
+			++m_numberOfItemsWithLargestRadius;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Several cells can share a bucket, so items are only visited when they're actually in the
+	cell being searched. Ranges covering more cells than there are items fall back to
+	visiting every item, which is cheaper at that point. */
+template< typename ItemFilter >
+void SpatialHashGrid::VisitItemsInCellRange( const CellCoordinates& minimumCell, const CellCoordinates& maximumCell, ItemFilter& filter ) const
+{
+	double numberOfCellsInRange = static_cast< double >( maximumCell.x - minimumCell.x + 1 )
+								* static_cast< double >( maximumCell.y - minimumCell.y + 1 )
+								* static_cast< double >( maximumCell.z - minimumCell.z + 1 );
+	if( numberOfCellsInRange > static_cast< double >( m_numberOfItems ) )
+	{
+		for( ItemID i = 0; i < m_items.size(); ++i )
+		{
+			const Item& item = m_items[ i ];
+			if( item.isInUse )
+				filter( i, item );
+		}
+		return;
+	}
+
+	CellCoordinates cell;
+	for( cell.z = minimumCell.z; cell.z <= maximumCell.z; ++cell.z )
+	{
+		for( cell.y = minimumCell.y; cell.y <= maximumCell.y; ++cell.y )
+		{
+			for( cell.x = minimumCell.x; cell.x <= maximumCell.x; ++cell.x )
+			{
+				ItemID i = m_bucketHeads[ GetBucketForCell( cell ) ];
+				while( i != ITEM_None )
+				{
+					const Item& item = m_items[ i ];
+					if( item.cell == cell )
+						filter( i, item );
+					i = item.nextInBucket;
+				}
+			}
+		}
+	}
+}
+#pragma endregion //Helpers
@@ -0,0 +1,106 @@
+#pragma once
+#ifndef INCLUDED_SPATIAL_HASH_GRID_HPP
+#define INCLUDED_SPATIAL_HASH_GRID_HPP
+
+//-----------------------------------------------------------------------------------------------
+#include <vector>
+
+#include "Math/FloatVector3.hpp"
+
+struct Entity;
+
+//-----------------------------------------------------------------------------------------------
+/* Broadphase for proximity queries. Space is divided into uniform cubic cells, and the cells are
+	hashed into a fixed number of buckets, so the grid is unbounded and only costs memory per item.
+
+	Each item is a bounding sphere filed under the cell containing its center. Moving an item
+	only touches the bucket lists when it crosses into a different cell, so updating many slow
+	movers every frame is cheap. Cells should be at least as large as a typical item's diameter;
+	queries widen their search by the largest radius of any item currently in the grid. */
+class SpatialHashGrid
+{
+public:
+	typedef unsigned int ItemID;
+	static const ItemID ITEM_None = 0xffffffff;
+
+	//-------------------------------------------------------------------------------------------
+	struct ItemPair
+	{
+		ItemPair( ItemID a, ItemID b ) : first( a ), second( b ) { }
+
+		ItemID first;
+		ItemID second;
+	};
+
+	SpatialHashGrid( float cellSize, unsigned int numberOfBuckets = 4096 );
+
+	//Items
+	ItemID InsertItem( Entity* entity, const FloatVector3& position, float radius );
+	void MoveItem( ItemID item, const FloatVector3& newPosition );
+	void RemoveItem( ItemID item );
+	void Clear();
+
+	size_t GetNumberOfItems() const { return m_numberOfItems; }
+	Entity* GetEntity( ItemID item ) const { return m_items[ item ].entity; }
+	const FloatVector3& GetPosition( ItemID item ) const { return m_items[ item ].position; }
+	float GetRadius( ItemID item ) const { return m_items[ item ].radius; }
+
+	//Queries (results are appended to out_items/out_pairs)
+	void FindItemsInRadius( const FloatVector3& center, float radius, std::vector< ItemID >& out_items ) const;
+	void FindItemsInBox( const FloatVector3& minimums, const FloatVector3& maximums, std::vector< ItemID >& out_items ) const;
+	void FindOverlappingPairs( std::vector< ItemPair >& out_pairs ) const;
+
+
+private:
+	//-------------------------------------------------------------------------------------------
+	struct CellCoordinates
+	{
+		bool operator==( const CellCoordinates& other ) const { return x == other.x && y == other.y && z == other.z; }
+		bool operator!=( const CellCoordinates& other ) const { return !( *this == other ); }
+
+		int x;
+		int y;
+		int z;
+	};
+
+	//-------------------------------------------------------------------------------------------
+	struct Item
+	{
+		Entity* entity;
+		FloatVector3 position;
+		float radius;
+		CellCoordinates cell;
+		ItemID previousInBucket;
+		ItemID nextInBucket;
+		bool isInUse;
+	};
+
+	struct RadiusQueryVisitor;
+	struct BoxQueryVisitor;
+	struct PairQueryVisitor;
+
+	//Helpers
+	CellCoordinates GetCellContainingPoint( const FloatVector3& point ) const;
+	unsigned int GetBucketForCell( const CellCoordinates& cell ) const;
+	void LinkItemIntoBucket( ItemID item );
+	void UnlinkItemFromBucket( ItemID item );
+	void RecalculateLargestItemRadius();
+
+	template< typename ItemFilter >
+	void VisitItemsInCellRange( const CellCoordinates& minimumCell, const CellCoordinates& maximumCell, ItemFilter& filter ) const;
+
+	//Data Members
+	float m_cellSize;
+	float m_inverseCellSize;
+	float m_largestItemRadius;
+	size_t m_numberOfItemsWithLargestRadius;
+
+	std::vector< Item > m_items;
+	std::vector< ItemID > m_freeItemIDs;
+	size_t m_numberOfItems;
+
+	std::vector< ItemID > m_bucketHeads;
+	unsigned int m_bucketMask;
+};
+
+#endif //INCLUDED_SPATIAL_HASH_GRID_HPP
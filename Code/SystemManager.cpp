@@ -0,0 +1,263 @@
+#include "SystemManager.hpp"
+
+#include "DebuggerInterface.hpp"
+#include "TimeInterface.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+bool SystemComponentAccess::ConflictsWith( const SystemComponentAccess& other ) const
+{
+	ComponentTypeMask componentsUsed = readComponents | writtenComponents;
+	ComponentTypeMask otherComponentsUsed = other.readComponents | other.writtenComponents;
+	if( ( ( writtenComponents & otherComponentsUsed ) != 0 ) || ( ( other.writtenComponents & componentsUsed ) != 0 ) )
+		return true;
+
+	//Only transforms can be shared between readers; using any other resource is exclusive
+	static const SharedResourceMask EXCLUSIVE_RESOURCES = ~GetSharedResourceMaskBit( SHARED_RESOURCE_EntityTransforms );
+
+	SharedResourceMask resourcesUsed = readResources | writtenResources;
+	SharedResourceMask otherResourcesUsed = other.readResources | other.writtenResources;
+	if( ( resourcesUsed & otherResourcesUsed & EXCLUSIVE_RESOURCES ) != 0 )
+		return true;
+	return ( ( writtenResources & otherResourcesUsed ) != 0 ) || ( ( other.writtenResources & resourcesUsed ) != 0 );
+}
+
+
+
+//-----------------------------------------------------------------------------------------------
+SystemManager::RegisteredSystem::RegisteredSystem( System* registeredSystem, const std::string& systemName,
+												   const SystemComponentAccess& declaredAccess, bool runsAlone )
+	: system( registeredSystem )
+	, name( systemName )
+	, access( declaredAccess )
+	, conflictsWithEverything( runsAlone )
+	, wave( 0 )
+	, lastUpdateSeconds( 0.0 )
+	, lastFinishSeconds( 0.0 )
+	, criticalPredecessor( SYSTEM_None )
+{ }
+
+//-----------------------------------------------------------------------------------------------
+SystemManager::SystemManager()
+	: m_scheduleIsDirty( false )
+	, m_updatingWave( nullptr )
+	, m_updateDeltaSeconds( 0.f )
+	, m_criticalPathSeconds( 0.0 )
+	, m_lastUpdateWallSeconds( 0.0 )
+{ }
+
+//-----------------------------------------------------------------------------------------------
+/* Systems are destroyed in the reverse of the order they were added. */
+SystemManager::~SystemManager()
+{
+	for( size_t i = m_systems.size(); i > 0; --i )
+	{
+		System* system = m_systems[ i - 1 ].system;
+		system->OnDestruction();
+		delete system;
+	}
+	m_systems.clear();
+}
+
+
+
+#pragma region System Registration
+//-----------------------------------------------------------------------------------------------
+SystemManager::SystemIndex SystemManager::AddSystem( System* system, const std::string& name )
+{
+	return RegisterSystem( system, name, SystemComponentAccess(), true );
+}
+
+//-----------------------------------------------------------------------------------------------
+SystemManager::SystemIndex SystemManager::AddSystem( System* system, const std::string& name, const SystemComponentAccess& access )
+{
+	return RegisterSystem( system, name, access, false );
+}
+#pragma endregion //System Registration
+
+
+
+#pragma region Frame Lifecycle
+//-----------------------------------------------------------------------------------------------
+void SystemManager::UpdateSystems( float deltaSeconds )
+{
+	static const size_t SYSTEMS_PER_JOB = 1;
+
+	if( m_scheduleIsDirty )
+		RebuildSchedule();
+
+	double startTimeSeconds = GetCurrentTimeSeconds();
+
+	m_updateDeltaSeconds = deltaSeconds;
+	for( unsigned int i = 0; i < m_waves.size(); ++i )
+	{
+		m_updatingWave = &m_waves[ i ];
+		if( m_updatingWave->size() == 1 )
+		{
+			UpdateSystem( m_updatingWave->front() );
+			continue;
+		}
+
+		JobSystem::ParallelFor( m_updatingWave->size(), SYSTEMS_PER_JOB,
+			ParallelForBody::GenerateFromOneArgFunction< SystemManager, &SystemManager::UpdateSystemsInWave >( this ) );
+	}
+	m_updatingWave = nullptr;
+
+	m_lastUpdateWallSeconds = GetCurrentTimeSeconds() - startTimeSeconds;
+	ComputeCriticalPath();
+}
+
+//-----------------------------------------------------------------------------------------------
+void SystemManager::RenderSystems() const
+{
+	for( unsigned int i = 0; i < m_systems.size(); ++i )
+	{
+		m_systems[ i ].system->OnRender();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void SystemManager::EndFrame()
+{
+	for( unsigned int i = 0; i < m_systems.size(); ++i )
+	{
+		m_systems[ i ].system->OnEndFrame();
+	}
+}
+#pragma endregion //Frame Lifecycle
+
+
+
+#pragma region Timing
+//-----------------------------------------------------------------------------------------------
+void SystemManager::PrintTimingReport() const
+{
+	PrintfToDebuggerOutput( "System update timings (wall %.3f ms, critical path %.3f ms):\n",
+		m_lastUpdateWallSeconds * 1000.0, m_criticalPathSeconds * 1000.0 );
+
+	SystemIndex criticalPathEnd = SYSTEM_None;
+	for( SystemIndex i = 0; i < m_systems.size(); ++i )
+	{
+		const RegisteredSystem& registeredSystem = m_systems[ i ];
+		PrintfToDebuggerOutput( "  [wave %u] %s: %.3f ms\n", registeredSystem.wave,
+			registeredSystem.name.c_str(), registeredSystem.lastUpdateSeconds * 1000.0 );
+
+		if( criticalPathEnd == SYSTEM_None || registeredSystem.lastFinishSeconds > m_systems[ criticalPathEnd ].lastFinishSeconds )
+			criticalPathEnd = i;
+	}
+
+	std::string criticalPath;
+	for( SystemIndex i = criticalPathEnd; i != SYSTEM_None; i = m_systems[ i ].criticalPredecessor )
+	{
+		criticalPath = ( criticalPath.empty() ) ? m_systems[ i ].name : m_systems[ i ].name + " -> " + criticalPath;
+	}
+	PrintfToDebuggerOutput( "  Critical path: %s\n", criticalPath.c_str() );
+}
+#pragma endregion //Timing
+
+
+
+#pragma region Scheduling
+//-----------------------------------------------------------------------------------------------
+SystemManager::SystemIndex SystemManager::RegisterSystem( System* system, const std::string& name,
+														  const SystemComponentAccess& access, bool conflictsWithEverything )
+{
+	FATAL_ASSERTION( system != nullptr, "System Manager Error",
+		"Cannot add a null system to the system manager!" );
+	FATAL_ASSERTION( m_updatingWave == nullptr, "System Manager Error",
+		"Systems cannot be added while the system manager is updating!" );
+
+	SystemIndex newSystemIndex = m_systems.size();
+	m_systems.push_back( RegisteredSystem( system, name, access, conflictsWithEverything ) );
+	m_scheduleIsDirty = true;
+
+	system->OnAttachment( this );
+	return newSystemIndex;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool SystemManager::SystemsConflict( const RegisteredSystem& first, const RegisteredSystem& second ) const
+{
+	if( first.conflictsWithEverything || second.conflictsWithEverything )
+		return true;
+	return first.access.ConflictsWith( second.access );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Each system depends on every earlier system it conflicts with, so the order systems are added
+	in decides who goes first. A system's wave is one past the latest wave it depends on. */
+void SystemManager::RebuildSchedule()
+{
+	m_waves.clear();
+	for( SystemIndex i = 0; i < m_systems.size(); ++i )
+	{
+		RegisteredSystem& registeredSystem = m_systems[ i ];
+		registeredSystem.dependencies.clear();
+		registeredSystem.wave = 0;
+
+		for( SystemIndex earlierIndex = 0; earlierIndex < i; ++earlierIndex )
+		{
+			const RegisteredSystem& earlierSystem = m_systems[ earlierIndex ];
+			if( !SystemsConflict( earlierSystem, registeredSystem ) )
+				continue;
+
+			registeredSystem.dependencies.push_back( earlierIndex );
+			if( earlierSystem.wave + 1 > registeredSystem.wave )
+				registeredSystem.wave = earlierSystem.wave + 1;
+		}
+
+		if( registeredSystem.wave >= m_waves.size() )
+			m_waves.resize( registeredSystem.wave + 1 );
+		m_waves[ registeredSystem.wave ].push_back( i );
+	}
+
+	m_scheduleIsDirty = false;
+}
+
+//-----------------------------------------------------------------------------------------------
+void SystemManager::UpdateSystemsInWave( JobRange& range )
+{
+	for( size_t i = range.startIndex; i < range.endIndex; ++i )
+	{
+		UpdateSystem( ( *m_updatingWave )[ i ] );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void SystemManager::UpdateSystem( SystemIndex index )
+{
+	RegisteredSystem& registeredSystem = m_systems[ index ];
+
+	double startTimeSeconds = GetCurrentTimeSeconds();
+	registeredSystem.system->OnUpdate( m_updateDeltaSeconds );
+	registeredSystem.lastUpdateSeconds = GetCurrentTimeSeconds() - startTimeSeconds;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* The critical path is the most expensive chain of dependent systems: with unlimited threads,
+	the update could finish no sooner than this. */
+void SystemManager::ComputeCriticalPath()
+{
+	m_criticalPathSeconds = 0.0;
+	for( SystemIndex i = 0; i < m_systems.size(); ++i )
+	{
+		RegisteredSystem& registeredSystem = m_systems[ i ];
+		registeredSystem.criticalPredecessor = SYSTEM_None;
+
+		double dependenciesFinishSeconds = 0.0;
+		for( unsigned int j = 0; j < registeredSystem.dependencies.size(); ++j )
+		{
+			SystemIndex dependencyIndex = registeredSystem.dependencies[ j ];
+			if( m_systems[ dependencyIndex ].lastFinishSeconds >= dependenciesFinishSeconds )
+			{
+				dependenciesFinishSeconds = m_systems[ dependencyIndex ].lastFinishSeconds;
+				registeredSystem.criticalPredecessor = dependencyIndex;
+			}
+		}
+
+		registeredSystem.lastFinishSeconds = dependenciesFinishSeconds + registeredSystem.lastUpdateSeconds;
+		if( registeredSystem.lastFinishSeconds > m_criticalPathSeconds )
+			m_criticalPathSeconds = registeredSystem.lastFinishSeconds;
+	}
+}
+#pragma endregion //Scheduling
@@ -0,0 +1,143 @@
+#pragma once
+#ifndef INCLUDED_SYSTEM_MANAGER_HPP
+#define INCLUDED_SYSTEM_MANAGER_HPP
+
+//-----------------------------------------------------------------------------------------------
+#include <string>
+#include <vector>
+
+#include "ComponentQuery.hpp"
+#include "JobSystem.hpp"
+#include "System.hpp"
+
+//-----------------------------------------------------------------------------------------------
+/* Engine state that isn't a component but that systems still contend over. Entity transforms are
+	read and written like components. The rest aren't safe to touch from two threads at once, so
+	any two systems that declare the same one of them never update concurrently. */
+enum SharedResource
+{
+	SHARED_RESOURCE_EntityTransforms,
+	SHARED_RESOURCE_EventCourier, //Subscribing, or sending events synchronously
+	SHARED_RESOURCE_EntityManager, //Hiring or firing entities, or attaching components
+	SHARED_RESOURCE_Renderer,
+	NUMBER_OF_SHARED_RESOURCES
+};
+
+
+
+//-----------------------------------------------------------------------------------------------
+/* The component types and shared resources a system reads and writes during OnUpdate. Two systems
+	conflict when either one writes something the other reads or writes. */
+struct SystemComponentAccess
+{
+	typedef unsigned int SharedResourceMask;
+
+	SystemComponentAccess()
+		: readComponents( 0 )
+		, writtenComponents( 0 )
+		, readResources( 0 )
+		, writtenResources( 0 )
+	{ }
+
+	template< typename ComponentType >
+	void AddRead() { readComponents |= GetQueryMaskBitForType< ComponentType >(); }
+
+	template< typename ComponentType >
+	void AddWrite() { writtenComponents |= GetQueryMaskBitForType< ComponentType >(); }
+
+	void AddRead( SharedResource resource ) { readResources |= GetSharedResourceMaskBit( resource ); }
+	void AddWrite( SharedResource resource ) { writtenResources |= GetSharedResourceMaskBit( resource ); }
+
+	bool ConflictsWith( const SystemComponentAccess& other ) const;
+
+	static SharedResourceMask GetSharedResourceMaskBit( SharedResource resource ) { return 1 << resource; }
+
+	//Data Members
+	ComponentTypeMask readComponents;
+	ComponentTypeMask writtenComponents;
+	SharedResourceMask readResources;
+	SharedResourceMask writtenResources;
+};
+
+
+
+//-----------------------------------------------------------------------------------------------
+/* Owns a game's systems and drives their lifecycle each frame.
+
+	Systems are scheduled from their declared component and resource access: a system depends on
+	every earlier-added system it conflicts with, and each frame's updates run in waves, where all
+	the systems in a wave are independent and update concurrently through the JobSystem.
+	Systems added without a declared access set conflict with everything and always run alone.
+
+	Rendering and end-of-frame work stay serial, in the order the systems were added.
+	GameInterface drives all three once per frame. */
+class SystemManager
+{
+public:
+	typedef unsigned int SystemIndex;
+	static const SystemIndex SYSTEM_None = 0xffffffff;
+
+	SystemManager();
+	~SystemManager();
+
+	//System Registration
+	SystemIndex AddSystem( System* system, const std::string& name );
+	SystemIndex AddSystem( System* system, const std::string& name, const SystemComponentAccess& access );
+	size_t GetNumberOfSystems() const { return m_systems.size(); }
+
+	//Frame Lifecycle
+	void UpdateSystems( float deltaSeconds );
+	void RenderSystems() const;
+	void EndFrame();
+
+	//Timing
+	double GetLastUpdateSeconds( SystemIndex index ) const { return m_systems[ index ].lastUpdateSeconds; }
+	double GetCriticalPathSeconds() const { return m_criticalPathSeconds; }
+	double GetLastUpdateWallSeconds() const { return m_lastUpdateWallSeconds; }
+	void PrintTimingReport() const;
+
+
+private:
+	//-------------------------------------------------------------------------------------------
+	struct RegisteredSystem
+	{
+		RegisteredSystem( System* registeredSystem, const std::string& systemName, const SystemComponentAccess& declaredAccess, bool runsAlone );
+
+		System* system;
+		std::string name;
+		SystemComponentAccess access;
+		bool conflictsWithEverything;
+
+		std::vector< SystemIndex > dependencies;
+		unsigned int wave;
+
+		double lastUpdateSeconds;
+		double lastFinishSeconds; //Along the longest dependency chain leading to this system
+		SystemIndex criticalPredecessor;
+	};
+
+	//Systems own plenty of state that shouldn't be shared between managers.
+	SystemManager( const SystemManager& other );
+	SystemManager& operator=( const SystemManager& other );
+
+	//Scheduling
+	SystemIndex RegisterSystem( System* system, const std::string& name, const SystemComponentAccess& access, bool conflictsWithEverything );
+	bool SystemsConflict( const RegisteredSystem& first, const RegisteredSystem& second ) const;
+	void RebuildSchedule();
+	void UpdateSystemsInWave( JobRange& range );
+	void UpdateSystem( SystemIndex index );
+	void ComputeCriticalPath();
+
+	//Data Members
+	std::vector< RegisteredSystem > m_systems;
+	std::vector< std::vector< SystemIndex > > m_waves;
+	bool m_scheduleIsDirty;
+
+	const std::vector< SystemIndex >* m_updatingWave;
+	float m_updateDeltaSeconds;
+
+	double m_criticalPathSeconds;
+	double m_lastUpdateWallSeconds;
+};
+
+#endif //INCLUDED_SYSTEM_MANAGER_HPP
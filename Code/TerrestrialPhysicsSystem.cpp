@@ -1,10 +1,29 @@
 #include "TerrestrialPhysicsSystem.hpp"
 
+#include "AssertionError.hpp"
+#include "Entity.hpp"
 #include "PhysicsComponent.hpp"
 
+//-----------------------------------------------------------------------------------------------
+static const float GROUND_HEIGHT = 2.f;
+
 
 
 #pragma region Lifecycle
+//-----------------------------------------------------------------------------------------------
+/* With the broadphase enabled, the component is filed immediately rather than after its first
+	step, since fixed timestep updates can run no steps at all. */
+void TerrestrialPhysicsSystem::AddPhysicsComponent( PhysicsComponent* physicsComponent )
+{
+	m_physComponents.AddElement( physicsComponent );
+	physicsComponent->wokenComponents = &m_wokenComponents;
+	if( physicsComponent->isAwake )
+		m_awakeComponents.push_back( physicsComponent );
+
+	if( m_broadphase != nullptr && physicsComponent->owner != nullptr )
+		InsertIntoBroadphase( physicsComponent );
+}
+
 //-----------------------------------------------------------------------------------------------
 void TerrestrialPhysicsSystem::OnAttachment( SystemManager* /*manager*/ )
 {
@@ -14,49 +33,544 @@ void TerrestrialPhysicsSystem::OnAttachment( SystemManager* /*manager*/ )
 //-----------------------------------------------------------------------------------------------
 void TerrestrialPhysicsSystem::OnEndFrame()
 {
-	for( unsigned int i = 0; i < m_physComponents.size(); ++i )
+	RemoveDeletedComponentsFromAwakeList();
+	if( m_broadphase != nullptr )
+		RemoveDeletedComponentsFromBroadphase();
+	m_physComponents.RemoveElementsReadyForDeletion();
+}
+
+//-----------------------------------------------------------------------------------------------
+void TerrestrialPhysicsSystem::OnUpdate( float deltaSeconds )
+{
+	FATAL_ASSERTION( !m_isDeterministic || m_timestepMode == TIMESTEP_FIXED, "Physics Error",
+		"Deterministic physics requires a fixed timestep!" );
+
+	if( m_timestepMode == TIMESTEP_FIXED )
+		IntegrateSteps( m_fixedStepSeconds, ConsumeAccumulatedSteps( deltaSeconds ) );
+	else
+		IntegrateSteps( deltaSeconds, 1 );
+}
+
+//-----------------------------------------------------------------------------------------------
+void TerrestrialPhysicsSystem::OnDestruction()
+{
+	m_awakeComponents.clear();
+	m_wokenComponents.clear();
+	m_physComponents.ReleaseAllElements();
+
+	delete m_broadphase;
+	m_broadphase = nullptr;
+}
+#pragma endregion //Lifecycle
+
+
+
+#pragma region Timestep
+//-----------------------------------------------------------------------------------------------
+/* maxStepsPerUpdate bounds how far the simulation will try to catch up after a long frame;
+	any time beyond that is dropped rather than carried into later frames. */
+void TerrestrialPhysicsSystem::UseFixedTimestep( float stepsPerSecond, unsigned int maxStepsPerUpdate )
+{
+	FATAL_ASSERTION( stepsPerSecond > 0.f && maxStepsPerUpdate > 0, "Physics Error",
+		"A fixed timestep needs a positive step rate and at least one step per update!" );
+
+	m_timestepMode = TIMESTEP_FIXED;
+	m_fixedStepSeconds = 1.f / stepsPerSecond;
+	m_maxStepsPerUpdate = maxStepsPerUpdate;
+	m_accumulatedSeconds = 0.f;
+	m_interpolationAlpha = 0.f;
+}
+
+//-----------------------------------------------------------------------------------------------
+void TerrestrialPhysicsSystem::UseVariableTimestep()
+{
+	m_timestepMode = TIMESTEP_VARIABLE;
+	m_accumulatedSeconds = 0.f;
+	m_interpolationAlpha = 1.f;
+}
+
+//-----------------------------------------------------------------------------------------------
+unsigned int TerrestrialPhysicsSystem::ConsumeAccumulatedSteps( float deltaSeconds )
+{
+	m_accumulatedSeconds += deltaSeconds;
+
+	unsigned int numberOfSteps = static_cast< unsigned int >( m_accumulatedSeconds / m_fixedStepSeconds );
+	if( numberOfSteps > m_maxStepsPerUpdate )
+	{
+		numberOfSteps = m_maxStepsPerUpdate;
+		m_accumulatedSeconds = numberOfSteps * m_fixedStepSeconds;
+	}
+
+	m_accumulatedSeconds -= numberOfSteps * m_fixedStepSeconds;
+	if( m_accumulatedSeconds < 0.f )
+		m_accumulatedSeconds = 0.f;
+
+	m_interpolationAlpha = m_accumulatedSeconds / m_fixedStepSeconds;
+	return numberOfSteps;
+}
+#pragma endregion //Timestep
+
+
+
+#pragma region Body Batch
+//-----------------------------------------------------------------------------------------------
+/* Each job only writes to the owners of the components in its own range, which assumes
+	no entity has more than one PhysicsComponent attached. Bodies never affect each other, so
+	the result doesn't depend on how the batch is split; deterministic mode still integrates
+	everything on the calling thread in component order, so no result can depend on timing. */
+void TerrestrialPhysicsSystem::IntegrateSteps( float stepSeconds, unsigned int numberOfSteps )
+{
+	if( numberOfSteps == 0 )
+		return;
+
+	m_numberOfStepsThisUpdate = numberOfSteps;
+	RemoveDeletedComponentsFromAwakeList(); //Owners fired mid-frame mustn't be integrated again
+	AddWokenBodiesToAwakeList();
+	FindAwakeBodySlots();
+	m_bodies.Resize( m_awakeComponents.size() );
+	m_positionsBeforeLastStep.resize( m_awakeComponents.size() );
+	m_currentStep = TerrestrialIntegrationStep( m_gravityAccelerationVector, stepSeconds, m_velocityRetainedPerSecond, GROUND_HEIGHT );
+
+	if( m_isDeterministic )
+	{
+		JobRange allBodies( 0, m_awakeComponents.size() );
+		UpdatePhysicsComponentRange( allBodies );
+	}
+	else
+	{
+		JobSystem::ParallelFor( m_awakeComponents.size(), PHYSICS_COMPONENTS_PER_JOB,
+			ParallelForBody::GenerateFromOneArgFunction< TerrestrialPhysicsSystem, &TerrestrialPhysicsSystem::UpdatePhysicsComponentRange >( this ) );
+	}
+
+	//With sleep disabled, or every body awake when the update began, the broadphase isn't queried;
+	//a body that only fell asleep during this update can be woken by the next one instead
+	m_touchedComponents.clear();
+	if( m_broadphase != nullptr )
+	{
+		UpdateBroadphase();
+		if( m_sleepSpeedSquared > 0.f && m_awakeComponents.size() < m_physComponents.GetNumberOfElements() )
+			FindSleepingBodiesTouchingAwakeBodies();
+	}
+
+	//Touched bodies are only woken once the ones that fell asleep this update are off the awake list
+	RemoveSleepingBodiesFromAwakeList();
+	for( size_t i = 0; i < m_touchedComponents.size(); ++i )
+	{
+		m_touchedComponents[ i ]->WakeUp();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Owners' kinematics are copied into the packed batch, integrated there several bodies at a time,
+	and copied back, so the integration itself never chases an owner pointer. All of an update's
+	fixed steps run on the batch between one gather and one scatter. */
+void TerrestrialPhysicsSystem::UpdatePhysicsComponentRange( JobRange& range )
+{
+	GatherBodies( range.startIndex, range.endIndex );
+	for( unsigned int step = 0; step < m_numberOfStepsThisUpdate; ++step )
 	{
-		if( m_physComponents[ i ]->IsReadyForDeletion() )
+		if( step + 1 == m_numberOfStepsThisUpdate )
 		{
-			delete m_physComponents[ i ];
-			m_physComponents.erase( m_physComponents.begin() + i );
+			for( size_t i = range.startIndex; i < range.endIndex; ++i )
+			{
+				m_positionsBeforeLastStep[ i ] = FloatVector3( m_bodies.positionX[ i ], m_bodies.positionY[ i ], m_bodies.positionZ[ i ] );
+			}
 		}
+
+		IntegrateTerrestrialBodies( m_bodies, range.startIndex, range.endIndex, m_currentStep );
 	}
+	ScatterBodies( range.startIndex, range.endIndex );
 }
 
 //-----------------------------------------------------------------------------------------------
-void TerrestrialPhysicsSystem::OnUpdate( float deltaSeconds )
+/* When every owner keeps its kinematics in the same transform store, bodies are gathered straight
+	from the store's channels by slot, without touching the owners at all. */
+void TerrestrialPhysicsSystem::GatherBodies( size_t firstBody, size_t endBody )
 {
-	for( unsigned int i = 0; i < m_physComponents.size(); ++i )
+	if( m_transformStore != nullptr )
+	{
+		const EntityTransformStore& store = *m_transformStore;
+		for( size_t i = firstBody; i < endBody; ++i )
+		{
+			EntityHandle::SlotIndex slot = m_awakeBodySlots[ i ];
+			m_bodies.positionX[ i ] = store.positionX[ slot ];
+			m_bodies.positionY[ i ] = store.positionY[ slot ];
+			m_bodies.positionZ[ i ] = store.positionZ[ slot ];
+			m_bodies.velocityX[ i ] = store.velocityX[ slot ];
+			m_bodies.velocityY[ i ] = store.velocityY[ slot ];
+			m_bodies.velocityZ[ i ] = store.velocityZ[ slot ];
+			m_bodies.gravityScale[ i ] = m_awakeComponents[ i ]->percentAcceleratedByGravity;
+		}
+		return;
+	}
+
+	for( size_t i = firstBody; i < endBody; ++i )
 	{
-		UpdatePhysicsComponent( m_physComponents[ i ], deltaSeconds );
+		const PhysicsComponent* physicsComponent = m_awakeComponents[ i ];
+		const Entity* physicsOwner = physicsComponent->owner;
+		FloatVector3 ownerPosition = physicsOwner->GetPosition();
+		FloatVector3 ownerVelocity = physicsOwner->GetVelocity();
+
+		m_bodies.positionX[ i ] = ownerPosition.x;
+		m_bodies.positionY[ i ] = ownerPosition.y;
+		m_bodies.positionZ[ i ] = ownerPosition.z;
+		m_bodies.velocityX[ i ] = ownerVelocity.x;
+		m_bodies.velocityY[ i ] = ownerVelocity.y;
+		m_bodies.velocityZ[ i ] = ownerVelocity.z;
+		m_bodies.gravityScale[ i ] = physicsComponent->percentAcceleratedByGravity;
 	}
 }
 
 //-----------------------------------------------------------------------------------------------
-void TerrestrialPhysicsSystem::OnDestruction()
+void TerrestrialPhysicsSystem::ScatterBodies( size_t firstBody, size_t endBody )
 {
-	for( unsigned int i = 0; i < m_physComponents.size(); ++i )
+	if( m_transformStore != nullptr )
 	{
-		delete m_physComponents[ i ];
+		EntityTransformStore& store = *m_transformStore;
+		for( size_t i = firstBody; i < endBody; ++i )
+		{
+			UpdateSleepState( m_awakeComponents[ i ], i );
+
+			EntityHandle::SlotIndex slot = m_awakeBodySlots[ i ];
+			store.SetPreviousPosition( slot, m_positionsBeforeLastStep[ i ] );
+			store.positionX[ slot ] = m_bodies.positionX[ i ];
+			store.positionY[ slot ] = m_bodies.positionY[ i ];
+			store.positionZ[ slot ] = m_bodies.positionZ[ i ];
+			store.velocityX[ slot ] = m_bodies.velocityX[ i ];
+			store.velocityY[ slot ] = m_bodies.velocityY[ i ];
+			store.velocityZ[ slot ] = m_bodies.velocityZ[ i ];
+		}
+		return;
+	}
+
+	for( size_t i = firstBody; i < endBody; ++i )
+	{
+		PhysicsComponent* physicsComponent = m_awakeComponents[ i ];
+		UpdateSleepState( physicsComponent, i );
+
+		Entity* physicsOwner = physicsComponent->owner;
+		physicsOwner->SetSimulatedPosition( m_positionsBeforeLastStep[ i ],
+			FloatVector3( m_bodies.positionX[ i ], m_bodies.positionY[ i ], m_bodies.positionZ[ i ] ) );
+		physicsOwner->SetVelocity( FloatVector3( m_bodies.velocityX[ i ], m_bodies.velocityY[ i ], m_bodies.velocityZ[ i ] ) );
 	}
-	m_physComponents.clear();
 }
-#pragma endregion //Lifecycle
+#pragma endregion //Body Batch
+
+
+
+#pragma region Rollback
+//-----------------------------------------------------------------------------------------------
+void TerrestrialPhysicsSystem::SaveSnapshot( PhysicsSnapshot& out_snapshot ) const
+{
+	size_t numberOfBodies = m_physComponents.GetNumberOfElements();
+	out_snapshot.simulation.accumulatedSeconds = m_accumulatedSeconds;
+	out_snapshot.simulation.interpolationAlpha = m_interpolationAlpha;
+	out_snapshot.simulation.numberOfBodies = static_cast< unsigned int >( numberOfBodies );
+	out_snapshot.bodies.resize( numberOfBodies );
+
+	for( size_t i = 0; i < numberOfBodies; ++i )
+	{
+		const PhysicsComponent* physicsComponent = m_physComponents[ i ];
+		const Entity* physicsOwner = physicsComponent->owner;
+		PhysicsSnapshot::BodyState& body = out_snapshot.bodies[ i ];
 
+		body.owner = physicsOwner->GetHandle();
+		body.position = physicsOwner->GetPosition();
+		body.previousPosition = physicsOwner->GetPreviousPosition();
+		body.velocity = physicsOwner->GetVelocity();
+		body.acceleration = physicsOwner->GetAcceleration();
+		body.orientation = physicsOwner->GetOrientation();
+		body.angularVelocity = physicsOwner->GetAngularVelocity();
 
+		body.percentAcceleratedByGravity = physicsComponent->percentAcceleratedByGravity;
+		body.collisionRadius = physicsComponent->collisionRadius;
+		body.secondsAtRest = physicsComponent->secondsAtRest;
+		body.isAwake = physicsComponent->isAwake ? 1 : 0;
+	}
+}
 
 //-----------------------------------------------------------------------------------------------
-void TerrestrialPhysicsSystem::UpdatePhysicsComponent( PhysicsComponent* physicsComponent, float deltaSeconds )
+/* The snapshot must come from this system with the same components attached; rollback can't
+	bring back components that were removed since, or drop ones added since. */
+void TerrestrialPhysicsSystem::RestoreSnapshot( const PhysicsSnapshot& snapshot )
 {
-	Entity*& physicsOwner = physicsComponent->owner;
-	physicsOwner->velocity += ( m_gravityAccelerationVector * physicsComponent->percentAcceleratedByGravity ) * deltaSeconds;
-	physicsOwner->position += physicsOwner->velocity * deltaSeconds;
+	FATAL_ASSERTION( snapshot.bodies.size() == m_physComponents.GetNumberOfElements(), "Physics Error",
+		"Cannot restore a physics snapshot taken with a different number of physics components!" );
+
+	m_accumulatedSeconds = snapshot.simulation.accumulatedSeconds;
+	m_interpolationAlpha = snapshot.simulation.interpolationAlpha;
+
+	for( size_t i = 0; i < snapshot.bodies.size(); ++i )
+	{
+		PhysicsComponent* physicsComponent = m_physComponents[ i ];
+		Entity* physicsOwner = physicsComponent->owner;
+		const PhysicsSnapshot::BodyState& body = snapshot.bodies[ i ];
+		FATAL_ASSERTION( physicsOwner->GetHandle() == body.owner, "Physics Error",
+			"Cannot restore a physics snapshot whose bodies belong to different entities than this system's components!" );
+
+		physicsOwner->SetSimulatedPosition( body.previousPosition, body.position );
+		physicsOwner->SetVelocity( body.velocity );
+		physicsOwner->SetAcceleration( body.acceleration );
+		physicsOwner->SetOrientation( body.orientation );
+		physicsOwner->SetAngularVelocity( body.angularVelocity );
+
+		physicsComponent->percentAcceleratedByGravity = body.percentAcceleratedByGravity;
+		physicsComponent->collisionRadius = body.collisionRadius;
+		physicsComponent->secondsAtRest = body.secondsAtRest;
+		physicsComponent->isAwake = ( body.isAwake != 0 );
+
+		if( m_broadphase != nullptr && physicsComponent->broadphaseItemID != SpatialHashGrid::ITEM_None )
+			m_broadphase->MoveItem( physicsComponent->broadphaseItemID, body.position );
+	}
+
+	RebuildAwakeList();
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Steps are taken immediately and the frame time accumulator is left alone, so re-simulating
+	after a restore takes exactly the steps it's asked to. */
+void TerrestrialPhysicsSystem::SimulateFixedSteps( unsigned int numberOfSteps )
+{
+	FATAL_ASSERTION( m_timestepMode == TIMESTEP_FIXED, "Physics Error",
+		"Simulating fixed steps requires a fixed timestep!" );
+
+	IntegrateSteps( m_fixedStepSeconds, numberOfSteps );
+}
+#pragma endregion //Rollback
+
+
+
+#pragma region Sleeping
+//-----------------------------------------------------------------------------------------------
+void TerrestrialPhysicsSystem::SetSleepThresholds( float sleepSpeed, float secondsAtRestBeforeSleep )
+{
+	m_sleepSpeedSquared = sleepSpeed * sleepSpeed;
+	m_secondsAtRestBeforeSleep = secondsAtRestBeforeSleep;
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Only needed when sleep flags change wholesale, as they do when a snapshot is restored. */
+void TerrestrialPhysicsSystem::RebuildAwakeList()
+{
+	m_awakeComponents.clear();
+	m_wokenComponents.clear();
+	for( size_t i = 0; i < m_physComponents.GetNumberOfElements(); ++i )
+	{
+		PhysicsComponent* physicsComponent = m_physComponents[ i ];
+		if( physicsComponent->isAwake )
+			m_awakeComponents.push_back( physicsComponent );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void TerrestrialPhysicsSystem::AddWokenBodiesToAwakeList()
+{
+	for( size_t i = 0; i < m_wokenComponents.size(); ++i )
+	{
+		PhysicsComponent* wokenComponent = m_wokenComponents[ i ];
+		if( wokenComponent->isAwake )
+			m_awakeComponents.push_back( wokenComponent );
+	}
+	m_wokenComponents.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Bodies are flagged asleep during the parallel scatter, and only dropped from the list here
+	on the updating thread, keeping the awake list in order. */
+void TerrestrialPhysicsSystem::RemoveSleepingBodiesFromAwakeList()
+{
+	size_t numberOfAwakeComponents = 0;
+	for( size_t i = 0; i < m_awakeComponents.size(); ++i )
+	{
+		if( m_awakeComponents[ i ]->isAwake )
+			m_awakeComponents[ numberOfAwakeComponents++ ] = m_awakeComponents[ i ];
+	}
+	m_awakeComponents.resize( numberOfAwakeComponents );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Must run before the end-of-frame sweep releases the components. Also runs before each update,
+	since a fired owner's slot is cleared at once and may be rehired before the sweep. */
+void TerrestrialPhysicsSystem::RemoveDeletedComponentsFromAwakeList()
+{
+	size_t numberOfKeptComponents = 0;
+	for( size_t i = 0; i < m_awakeComponents.size(); ++i )
+	{
+		if( !m_awakeComponents[ i ]->IsReadyForDeletion() )
+			m_awakeComponents[ numberOfKeptComponents++ ] = m_awakeComponents[ i ];
+	}
+	m_awakeComponents.resize( numberOfKeptComponents );
+
+	numberOfKeptComponents = 0;
+	for( size_t i = 0; i < m_wokenComponents.size(); ++i )
+	{
+		if( !m_wokenComponents[ i ]->IsReadyForDeletion() )
+			m_wokenComponents[ numberOfKeptComponents++ ] = m_wokenComponents[ i ];
+	}
+	m_wokenComponents.resize( numberOfKeptComponents );
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Notes each awake owner's transform store slot, so gather and scatter can go straight to
+	the store when all of the owners share one. Every awake owner is checked against the handle
+	its component was attached with, since a fired and rehired owner would otherwise be
+	integrated as if it were still the body's entity. */
+void TerrestrialPhysicsSystem::FindAwakeBodySlots()
+{
+	m_awakeBodySlots.resize( m_awakeComponents.size() );
+	m_transformStore = nullptr;
+	if( m_awakeComponents.empty() )
+		return;
+
+	m_transformStore = m_awakeComponents[ 0 ]->owner->GetTransformStore();
+	for( size_t i = 0; i < m_awakeComponents.size(); ++i )
+	{
+		const PhysicsComponent* physicsComponent = m_awakeComponents[ i ];
+		FATAL_ASSERTION( physicsComponent->OwnerIsCurrent(), "Physics Error",
+			"An awake physics component's owner was fired while the component was still being simulated!" );
+
+		const Entity* physicsOwner = physicsComponent->owner;
+		if( physicsOwner->GetTransformStore() != m_transformStore )
+			m_transformStore = nullptr;
+		m_awakeBodySlots[ i ] = physicsOwner->GetHandle().slotIndex;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+/* A body falling asleep is also brought to a dead stop, so it doesn't render as drifting and
+	picks up exactly where it left off when woken. */
+void TerrestrialPhysicsSystem::UpdateSleepState( PhysicsComponent* physicsComponent, size_t body )
+{
+	float speedSquared = m_bodies.velocityX[ body ] * m_bodies.velocityX[ body ]
+					   + m_bodies.velocityY[ body ] * m_bodies.velocityY[ body ]
+					   + m_bodies.velocityZ[ body ] * m_bodies.velocityZ[ body ];
+	if( speedSquared >= m_sleepSpeedSquared )
+	{
+		physicsComponent->secondsAtRest = 0.f;
+		return;
+	}
+
+	physicsComponent->secondsAtRest += m_currentStep.deltaSeconds * m_numberOfStepsThisUpdate;
+	if( physicsComponent->secondsAtRest < m_secondsAtRestBeforeSleep )
+		return;
+
+	physicsComponent->isAwake = false;
+	m_positionsBeforeLastStep[ body ] = FloatVector3( m_bodies.positionX[ body ], m_bodies.positionY[ body ], m_bodies.positionZ[ body ] );
+	m_bodies.velocityX[ body ] = m_bodies.velocityY[ body ] = m_bodies.velocityZ[ body ] = 0.f;
+}
+#pragma endregion //Sleeping
+
+
+
+#pragma region Broadphase
+//-----------------------------------------------------------------------------------------------
+void TerrestrialPhysicsSystem::EnableBroadphase( float cellSize )
+{
+	FATAL_ASSERTION( m_broadphase == nullptr, "Physics Error",
+		"The physics broadphase was already enabled!" );
+
+	m_broadphase = new SpatialHashGrid( cellSize );
+	for( size_t i = 0; i < m_physComponents.GetNumberOfElements(); ++i )
+	{
+		InsertIntoBroadphase( m_physComponents[ i ] );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Runs on the updating thread after the parallel integration, since moving items relinks
+	the grid's shared buckets. Sleeping bodies haven't moved, so only this update's awake bodies
+	are touched. Components added before their owner was set are filed here. */
+void TerrestrialPhysicsSystem::UpdateBroadphase()
+{
+	for( size_t i = 0; i < m_awakeComponents.size(); ++i )
+	{
+		PhysicsComponent* physicsComponent = m_awakeComponents[ i ];
+		Entity* physicsOwner = physicsComponent->owner;
+
+		if( physicsComponent->broadphaseItemID == SpatialHashGrid::ITEM_None )
+			InsertIntoBroadphase( physicsComponent );
+		else
+			m_broadphase->MoveItem( physicsComponent->broadphaseItemID, physicsOwner->GetPosition() );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Bodies don't push each other here, but a sleeping body that something has run into can't stay
+	asleep, so these get woken. Only bodies moving faster than the sleep speed wake others, so two settling bodies that
+	rest against each other don't keep waking each other up. Anything woken starts integrating on
+	the next update. */
+void TerrestrialPhysicsSystem::FindSleepingBodiesTouchingAwakeBodies()
+{
+	for( size_t i = 0; i < m_awakeComponents.size(); ++i )
+	{
+		const PhysicsComponent* physicsComponent = m_awakeComponents[ i ];
+		float speedSquared = m_bodies.velocityX[ i ] * m_bodies.velocityX[ i ]
+						   + m_bodies.velocityY[ i ] * m_bodies.velocityY[ i ]
+						   + m_bodies.velocityZ[ i ] * m_bodies.velocityZ[ i ];
+		if( speedSquared < m_sleepSpeedSquared )
+			continue;
+
+		m_touchingItems.clear();
+		m_broadphase->FindItemsInRadius( m_broadphase->GetPosition( physicsComponent->broadphaseItemID ), physicsComponent->collisionRadius, m_touchingItems );
+		for( size_t j = 0; j < m_touchingItems.size(); ++j )
+		{
+			PhysicsComponent* touchedComponent = m_componentsByBroadphaseItem[ m_touchingItems[ j ] ];
+			if( !touchedComponent->isAwake && !touchedComponent->IsReadyForDeletion() )
+				m_touchedComponents.push_back( touchedComponent );
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void TerrestrialPhysicsSystem::InsertIntoBroadphase( PhysicsComponent* physicsComponent )
+{
+	Entity* physicsOwner = physicsComponent->owner;
+	SpatialHashGrid::ItemID newItemID = m_broadphase->InsertItem( physicsOwner, physicsOwner->GetPosition(), physicsComponent->collisionRadius );
+
+	if( newItemID >= m_componentsByBroadphaseItem.size() )
+		m_componentsByBroadphaseItem.resize( newItemID + 1, nullptr );
+	m_componentsByBroadphaseItem[ newItemID ] = physicsComponent;
+	physicsComponent->broadphaseItemID = newItemID;
+}
+
+//-----------------------------------------------------------------------------------------------
+void TerrestrialPhysicsSystem::RemoveDeletedComponentsFromBroadphase()
+{
+	for( size_t i = 0; i < m_physComponents.GetNumberOfElements(); ++i )
+	{
+		PhysicsComponent* physicsComponent = m_physComponents[ i ];
+		if( !physicsComponent->IsReadyForDeletion() || physicsComponent->broadphaseItemID == SpatialHashGrid::ITEM_None )
+			continue;
+
+		m_broadphase->RemoveItem( physicsComponent->broadphaseItemID );
+		m_componentsByBroadphaseItem[ physicsComponent->broadphaseItemID ] = nullptr;
+		physicsComponent->broadphaseItemID = SpatialHashGrid::ITEM_None;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+/* Sleeping bodies near an explosion, a removed support, etc. need waking explicitly.
+	Without a broadphase, every body is checked. */
+void TerrestrialPhysicsSystem::WakeBodiesInRadius( const FloatVector3& center, float radius )
+{
+	if( m_broadphase != nullptr )
+	{
+		std::vector< SpatialHashGrid::ItemID > itemsInRadius;
+		m_broadphase->FindItemsInRadius( center, radius, itemsInRadius );
+		for( size_t i = 0; i < itemsInRadius.size(); ++i )
+		{
+			m_componentsByBroadphaseItem[ itemsInRadius[ i ] ]->WakeUp();
+		}
+		return;
+	}
 
-	physicsOwner->velocity *= 0.9f;
-	if( physicsOwner->position.z < 2.f )
+	for( size_t i = 0; i < m_physComponents.GetNumberOfElements(); ++i )
 	{
-		physicsOwner->velocity.z = 0.f;
-		physicsOwner->position.z = 2.f;
+		PhysicsComponent* physicsComponent = m_physComponents[ i ];
+		FloatVector3 displacement = physicsComponent->owner->GetPosition() - center;
+		float touchingDistance = radius + physicsComponent->collisionRadius;
+		if( displacement.CalculateSquaredNorm() <= touchingDistance * touchingDistance )
+			physicsComponent->WakeUp();
 	}
 }
+#pragma endregion //Broadphase
@@ -6,18 +6,74 @@
 #include <vector>
 
 #include "Math/FloatVector3.hpp"
+#include "DeferredRemovalVector.hpp"
+#include "EntityTransformStore.hpp"
+#include "JobSystem.hpp"
+#include "PhysicsBodyBatch.hpp"
+#include "PhysicsComponent.hpp"
+#include "PhysicsSnapshot.hpp"
+#include "SpatialHashGrid.hpp"
 #include "System.hpp"
 
-struct PhysicsComponent;
-
 
 //-----------------------------------------------------------------------------------------------
+/* By default each update integrates one step of the frame's raw deltaSeconds. In fixed timestep mode,
+	frame time is banked in an accumulator and spent in steps of exactly 1/stepsPerSecond, so a hitch
+	can't produce one huge step and every machine integrates the same steps. Entities are left at their
+	latest simulated state; renderers draw them at GetInterpolationAlpha() of the way from their
+	position before the last step to their position after it.
+
+	Sleeping is opt-in through SetSleepThresholds. Once enabled, a body that stays slower than the
+	sleep speed for long enough is put to sleep: its velocity is zeroed and it is skipped by gather,
+	integration, scatter and the broadphase until something calls WakeUp() on its component, e.g.
+	through WakeBodiesInRadius(). Anything that moves a sleeping body's owner directly must wake it.
+	Bodies never push each other here, so each body is its own island. The awake bodies are kept in
+	their own list, updated as bodies fall asleep and wake up, so sleeping bodies cost nothing per
+	update.
+
+	Once the broadphase is enabled, every component's owner is kept in a spatial hash as a sphere of
+	the component's collisionRadius, updated after each integration, for collision and proximity queries.
+	Components should be attached to their owners before they're added, so they can be filed right
+	away. After each integration, sleeping bodies touched by an awake body are woken through it.
+
+	For rollback, SaveSnapshot/RestoreSnapshot capture and rewind the whole simulation, and
+	SimulateFixedSteps re-runs steps without going through the frame time accumulator. */
 class TerrestrialPhysicsSystem : public System
 {
 public:
+	typedef unsigned char TimestepMode;
+	static const TimestepMode TIMESTEP_VARIABLE = 0;
+	static const TimestepMode TIMESTEP_FIXED = 1;
+
 	TerrestrialPhysicsSystem( const FloatVector3& gravityForceVector );
 
-	void AddPhysicsComponent( PhysicsComponent* physicsComponent ) { m_physComponents.push_back( physicsComponent ); }
+	void AddPhysicsComponent( PhysicsComponent* physicsComponent );
+	void SetPhysicsComponentReleaser( const DeferredRemovalVector< PhysicsComponent >::ElementReleaser& releaser ) { m_physComponents.SetElementReleaser( releaser ); }
+
+	//The fraction of its velocity a body keeps after one second of damping
+	void SetVelocityRetainedPerSecond( float velocityRetainedPerSecond ) { m_velocityRetainedPerSecond = velocityRetainedPerSecond; }
+
+	//Sleeping (the default sleep speed of zero keeps every body awake)
+	void SetSleepThresholds( float sleepSpeed, float secondsAtRestBeforeSleep );
+	size_t GetNumberOfAwakeBodies() const { return m_awakeComponents.size() + m_wokenComponents.size(); }
+
+	//Broadphase
+	void EnableBroadphase( float cellSize );
+	const SpatialHashGrid* GetBroadphase() const { return m_broadphase; }
+	void WakeBodiesInRadius( const FloatVector3& center, float radius );
+
+	//Timestep
+	void UseFixedTimestep( float stepsPerSecond, unsigned int maxStepsPerUpdate );
+	void UseVariableTimestep();
+	TimestepMode GetTimestepMode() const { return m_timestepMode; }
+	float GetInterpolationAlpha() const { return m_interpolationAlpha; }
+
+	//Rollback
+	void SaveSnapshot( PhysicsSnapshot& out_snapshot ) const;
+	void RestoreSnapshot( const PhysicsSnapshot& snapshot );
+	void SimulateFixedSteps( unsigned int numberOfSteps );
+	void SetDeterministic( bool isDeterministic ) { m_isDeterministic = isDeterministic; }
+	bool IsDeterministic() const { return m_isDeterministic; }
 
 	//Lifecycle
 	void OnAttachment( SystemManager* manager );
@@ -28,12 +84,53 @@ public:
 
 
 private:
-	void UpdatePhysicsComponent( PhysicsComponent* physicsComponent, float deltaSeconds );
+	//Components are independent of each other, so they're integrated in parallel in batches of this size
+	static const size_t PHYSICS_COMPONENTS_PER_JOB = 256;
+
+	void IntegrateSteps( float stepSeconds, unsigned int numberOfSteps );
+	void RebuildAwakeList();
+	void AddWokenBodiesToAwakeList();
+	void RemoveSleepingBodiesFromAwakeList();
+	void RemoveDeletedComponentsFromAwakeList();
+	void FindAwakeBodySlots();
+	void UpdatePhysicsComponentRange( JobRange& range );
+	void GatherBodies( size_t firstBody, size_t endBody );
+	void ScatterBodies( size_t firstBody, size_t endBody );
+	void UpdateSleepState( PhysicsComponent* physicsComponent, size_t body );
+	unsigned int ConsumeAccumulatedSteps( float deltaSeconds );
+	void UpdateBroadphase();
+	void FindSleepingBodiesTouchingAwakeBodies();
+	void InsertIntoBroadphase( PhysicsComponent* physicsComponent );
+	void RemoveDeletedComponentsFromBroadphase();
 
 	//Data Members
 	FloatVector3 m_gravityAccelerationVector;
-	std::vector< PhysicsComponent* > m_physComponents;
+	float m_velocityRetainedPerSecond;
+	DeferredRemovalVector< PhysicsComponent > m_physComponents;
+	std::vector< PhysicsComponent* > m_awakeComponents;
+	std::vector< PhysicsComponent* > m_wokenComponents; //Woken since the last update; see PhysicsComponent::WakeUp
+	PhysicsBodyBatch m_bodies; //Body i belongs to m_awakeComponents[ i ]
+	EntityTransformStore* m_transformStore; //Shared by every awake body's owner, or nullptr if they don't all share one
+	std::vector< EntityHandle::SlotIndex > m_awakeBodySlots; //Body i's owner's slot in m_transformStore
+	std::vector< FloatVector3 > m_positionsBeforeLastStep;
+	TerrestrialIntegrationStep m_currentStep;
+	unsigned int m_numberOfStepsThisUpdate;
+	SpatialHashGrid* m_broadphase;
+	std::vector< PhysicsComponent* > m_componentsByBroadphaseItem;
+
+	//Sleeping
+	float m_sleepSpeedSquared;
+	float m_secondsAtRestBeforeSleep;
+	std::vector< PhysicsComponent* > m_touchedComponents; //Scratch space, refilled every update
+	std::vector< SpatialHashGrid::ItemID > m_touchingItems; //Scratch space, refilled every update
 
+	//Timestep
+	TimestepMode m_timestepMode;
+	float m_fixedStepSeconds;
+	unsigned int m_maxStepsPerUpdate;
+	float m_accumulatedSeconds;
+	float m_interpolationAlpha;
+	bool m_isDeterministic;
 };
 
 
@@ -41,6 +138,19 @@ private:
 //-----------------------------------------------------------------------------------------------
 inline TerrestrialPhysicsSystem::TerrestrialPhysicsSystem( const FloatVector3& gravityForceVector )
 	: m_gravityAccelerationVector( gravityForceVector )
+	, m_velocityRetainedPerSecond( 0.0017970103f ) //0.9 per frame at 60 fps, which is what bodies used to lose every frame
+	, m_transformStore( nullptr )
+	, m_currentStep( gravityForceVector, 0.f, 1.f, 0.f )
+	, m_numberOfStepsThisUpdate( 0 )
+	, m_broadphase( nullptr )
+	, m_sleepSpeedSquared( 0.f )
+	, m_secondsAtRestBeforeSleep( 0.5f )
+	, m_timestepMode( TIMESTEP_VARIABLE )
+	, m_fixedStepSeconds( 0.f )
+	, m_maxStepsPerUpdate( 1 )
+	, m_accumulatedSeconds( 0.f )
+	, m_interpolationAlpha( 1.f )
+	, m_isDeterministic( false )
 { }
 
 #endif //INCLUDED_TERRESTRIAL_PHYSICS_SYSTEM_HPP
@@ -24,6 +24,7 @@
 #include "CommandLineManager.hpp"
 #include "DebuggerInterface.hpp"
 #include "GameInterface.hpp"
+#include "JobSystem.hpp"
 #include "StringConversion.hpp"
 #include "TimeInterface.hpp"
 
@@ -470,6 +471,7 @@ void Update( double timeSpentLastFrameSeconds )
 void Render()
 {
 	GameInterface::Render();
+	RendererInterface::EndFrame();
 
 	SwapBuffers( g_displayDeviceContext );
 }
@@ -557,6 +559,7 @@ int WINAPI WinMain( HINSTANCE applicationInstanceHandle, HINSTANCE, LPSTR comman
 	CreateOpenGLWindow( APP_NAME, applicationInstanceHandle );
 
 	EventCourier::Startup();
+	JobSystem::Startup();
 	RendererInterface::Startup();
 	AudioInterface::Startup();
 	PeripheralInterface::Startup();
@@ -582,6 +585,7 @@ int WINAPI WinMain( HINSTANCE applicationInstanceHandle, HINSTANCE, LPSTR comman
 
 	//TempClearShaderPrograms();
 
+	JobSystem::Shutdown();
 	EventCourier::Shutdown();
 	CommandLine::Manager::Destroy();
 
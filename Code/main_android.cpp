@@ -20,6 +20,7 @@
 #include "Input/PeripheralInterface.hpp"
 #include "AssetInterface.hpp"
 #include "GameInterface.hpp"
+#include "JobSystem.hpp"
 #include "TimeInterface.hpp"
 
 
@@ -165,6 +166,7 @@ void StartUpVingine( struct engine& engine )
 	GameInterface::BeforeEngineInitialization();
 
 	EventCourier::Startup();
+	JobSystem::Startup();
 	RendererInterface::Startup();
 	AudioInterface::Startup();
 	PeripheralInterface::Startup();
@@ -190,6 +192,7 @@ void ShutDownVingine()
 	PeripheralInterface::Shutdown();
 	AudioInterface::Shutdown();
 	RendererInterface::Shutdown();
+	JobSystem::Shutdown();
 	EventCourier::Shutdown();
 
 	GameInterface::AfterEngineDestruction();
@@ -470,6 +473,7 @@ void Update( double timeSpentLastFrameSeconds )
 void Render( struct engine& engine )
 {
 	GameInterface::Render();
+	RendererInterface::EndFrame();
 
 	eglSwapBuffers( engine.display, engine.surface );
 }
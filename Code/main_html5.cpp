@@ -252,6 +252,7 @@ void Update( double deltaSeconds )
 void Render()
 {
 	GameInterface::Render();
+	RendererInterface::EndFrame();
 
 	SDL_Flip( g_canvas ); //Strange name; swaps the two render buffers.
 }
@@ -0,0 +1,29 @@
+#version 330
+//Vertex Shader - Shader language 3.30, for OpenGL 3.3
+//Instanced variant of BasicNoTexture.330.vertex.glsl; pair it with BasicNoTexture.330.fragment.glsl
+
+//INPUTS:
+in vec3 i_vertexWorldPosition;	//= vertex position in world space (raw, from VBO)
+in vec4 i_vertexColor;			//= vertex Color, should be 4 floats
+in mat4 i_instanceModelMatrix;	//= model matrix of this instance, replaces u_modelMatrix
+
+uniform mat4 u_projectionMatrix; //= current projection matrix
+uniform mat4 u_viewMatrix; //= current view matrix
+
+//OUTPUTS:
+out vec4 screenPosition;		//= vertex position in screen space
+out vec4 worldPosition;			//= vertex position in world space
+out vec4 surfaceColor;			//= color of the surface
+
+
+//-----------------------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------------------------
+void main()
+{
+	vec4 i_vertexWorldPosition4 = vec4( i_vertexWorldPosition.x, i_vertexWorldPosition.y, i_vertexWorldPosition.z, 1.0 );
+	screenPosition = u_projectionMatrix * u_viewMatrix * i_instanceModelMatrix * i_vertexWorldPosition4;
+	gl_Position = screenPosition;
+	worldPosition = i_instanceModelMatrix * i_vertexWorldPosition4;
+	surfaceColor = i_vertexColor;
+}